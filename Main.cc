@@ -1,10 +1,13 @@
 #include <algorithm>
+#include <chrono>
 #include <cstdlib>
 #include <format>
 #include <iostream>
+#include <memory_resource>
 #include <optional>
 #include <string>
 #include <string_view>
+#include <utility>
 #include <vector>
 
 #include <pvk/device.hh>
@@ -76,6 +79,14 @@ struct Application
                 "Found {} device \"{}\"\n",
                 device_type_to_str(device.get_device_type()),
                 device.get_name());
+
+            HostMemoryStats stats = device.get_host_memory_stats();
+            std::cout << std::format(
+                "  driver host memory: {} bytes live, {} bytes peak, "
+                "{} allocations\n",
+                stats.total.live_bytes,
+                stats.total.peak_bytes,
+                stats.total.allocations);
         };
         std::ranges::for_each(devices, log_device);
     }
@@ -88,7 +99,10 @@ struct Application
 
 Application::Application()
 {
-    m_vk_context = Instance::create();
+    // Setup temporaries all come from one arena released at the end
+    std::pmr::monotonic_buffer_resource scratch;
+
+    m_vk_context = Instance::create(&scratch);
     if (!m_vk_context) {
         return;
     }
@@ -99,6 +113,9 @@ Application::Application()
 
     for (size_t device_idx = 0; device_idx < devices_count; device_idx++) {
         std::optional<Device> device = m_vk_context->get_device(device_idx);
+        if (!device) {
+            continue;
+        }
 
         std::cout << std::format(
             "Device #{} - {} ({})\n",
@@ -106,7 +123,19 @@ Application::Application()
             device->get_name(),
             device_type_to_str(device->get_device_type()));
 
-        device->connect();
+        devices.emplace_back(std::move(*device));
+    }
+
+    // Startup takes as long as the slowest device, not the sum of them
+    auto results = m_vk_context->connect_devices(devices);
+    for (size_t device_idx = 0; device_idx < results.size(); device_idx++) {
+        std::cout << std::format(
+            "Device #{} {} in {:.3f} ms\n",
+            device_idx,
+            results[device_idx].connected ? "connected" : "not connected",
+            std::chrono::duration<double, std::milli>(
+                results[device_idx].latency)
+                .count());
     }
 }
 
@@ -0,0 +1,173 @@
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <utility>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+#include "pvk/log.hh"
+
+#include "pvk/internal/alloc_trace.hh"
+
+namespace {
+
+constexpr size_t thread_buffer_records = 1024;
+
+uint32_t next_thread_id() noexcept
+{
+    static std::atomic<uint32_t> counter{0};
+    return counter.fetch_add(1, std::memory_order_relaxed);
+}
+
+struct ThreadBuffer
+{
+    ThreadBuffer() = default;
+    ThreadBuffer(const ThreadBuffer &) = delete;
+    ThreadBuffer &operator=(const ThreadBuffer &) = delete;
+
+    ~ThreadBuffer()
+    {
+        flush();
+    }
+
+    void flush() noexcept;
+
+    using Records = std::array<pvk::AllocTrace::Record, thread_buffer_records>;
+
+    // Allocated on first use so untraced threads do not pay for it
+    std::shared_ptr<pvk::AllocTrace> trace;
+    std::unique_ptr<Records> records;
+    size_t count = 0;
+    uint32_t thread_id = next_thread_id();
+};
+
+thread_local ThreadBuffer thread_buffer;
+
+} // namespace
+
+namespace pvk {
+
+std::shared_ptr<AllocTrace> AllocTrace::open(const std::string &path) noexcept
+try {
+    std::shared_ptr<AllocTrace> output(new AllocTrace());
+    output->m_file = std::fopen(path.c_str(), "wb");
+    if (output->m_file == nullptr) {
+        pvk::warning("AllocTrace: cannot open \"{}\" for writing", path);
+        return nullptr;
+    }
+
+    FileHeader header{magic, version, sizeof(Record)};
+    if (std::fwrite(&header, sizeof(header), 1, output->m_file) != 1) {
+        pvk::warning("AllocTrace: cannot write header to \"{}\"", path);
+        return nullptr;
+    }
+
+    pvk::info("AllocTrace: recording host allocations to \"{}\"", path);
+    return output;
+} catch (...) {
+    return nullptr;
+}
+
+std::shared_ptr<AllocTrace> AllocTrace::from_environment() noexcept
+{
+    static std::shared_ptr<AllocTrace> trace = []() {
+        const char *path = std::getenv("PVK_ALLOCATION_TRACE");
+        if (path == nullptr || *path == '\0') {
+            return std::shared_ptr<AllocTrace>();
+        }
+        return AllocTrace::open(path);
+    }();
+    return trace;
+}
+
+void AllocTrace::record(
+    const std::shared_ptr<AllocTrace> &trace,
+    Event event,
+    const void *block,
+    const void *original,
+    size_t size,
+    size_t alignment,
+    uint8_t scope,
+    uint64_t timestamp_ns) noexcept
+{
+    ThreadBuffer &buffer = thread_buffer;
+    if (buffer.trace != trace) {
+        buffer.flush();
+        buffer.trace = trace;
+    }
+
+    if (buffer.records == nullptr) {
+        buffer.records.reset(new (std::nothrow) ThreadBuffer::Records);
+    }
+    if (buffer.records == nullptr) {
+        return;
+    }
+
+    Record &r = (*buffer.records)[buffer.count++];
+    r.timestamp_ns = timestamp_ns != 0 ? timestamp_ns : now();
+    r.block = reinterpret_cast<size_t>(block);
+    r.original = reinterpret_cast<size_t>(original);
+    r.size = size;
+    r.thread = buffer.thread_id;
+    r.event = event;
+    r.scope = scope;
+    r.align_log2 = static_cast<uint8_t>(std::countr_zero(alignment));
+    r.reserved = 0;
+
+    if (buffer.count == thread_buffer_records) {
+        trace->write(buffer.records->data(), buffer.count);
+        buffer.count = 0;
+    }
+}
+
+uint64_t AllocTrace::now() noexcept
+{
+    auto since_epoch = std::chrono::steady_clock::now().time_since_epoch();
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(since_epoch)
+            .count());
+}
+
+void AllocTrace::flush_thread() noexcept
+{
+    thread_buffer.flush();
+}
+
+void AllocTrace::write(const Record *records, size_t count) noexcept
+{
+    std::lock_guard guard(m_lock);
+    if (m_file == nullptr) {
+        return;
+    }
+    std::fwrite(records, sizeof(Record), count, m_file);
+}
+
+AllocTrace::~AllocTrace() noexcept
+{
+    if (m_file != nullptr) {
+        std::fclose(m_file);
+    }
+}
+
+} // namespace pvk
+
+namespace {
+
+void ThreadBuffer::flush() noexcept
+{
+    if (trace != nullptr && count != 0) {
+        trace->write(records->data(), count);
+    }
+    count = 0;
+    trace.reset();
+}
+
+} // namespace
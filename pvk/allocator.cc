@@ -1,30 +1,147 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
 #include <cstddef>
 #include <cstdlib>
 #include <cstring>
 #include <format>
 #include <iterator>
+#include <memory_resource>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
 
 #include "pvk/log.hh"
 
+#include "pvk/internal/host_heap.hh"
 #include "pvk/internal/vk_allocator.hh"
 
 namespace {
-static void *aligned_alloc_wrap(size_t alignment, size_t aligned_size)
+
+using pvk::host_heap::Pool;
+
+// Where the slab and page backed blocks of an Allocator come from
+struct Placement
 {
-#if defined(PVK_USE_WINDOWS_ALIGNED_ALLOC)
-    return _aligned_malloc(aligned_size, alignment);
-#else
-    return std::aligned_alloc(alignment, aligned_size);
-#endif
+    // PERSISTENT or, with huge pages enabled, HUGE_PERSISTENT
+    Pool persistent;
+    int node;
+};
+
+static Pool pool_of(VkSystemAllocationScope scope, Pool persistent)
+{
+    switch (scope) {
+    case VK_SYSTEM_ALLOCATION_SCOPE_DEVICE:
+    case VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE:
+        return persistent;
+    default:
+        return Pool::OBJECT;
+    }
 }
 
-static void aligned_free_wrap(void *p)
+/*
+ * Command scoped blocks live only for the duration of a single Vulkan
+ * command and go to the bump arena, everything else goes to the slabs
+ * of its lifetime pool. Both directions decide by the same MemBlock,
+ * so the free path always finds the allocation path's backend.
+ */
+static bool uses_arena(const pvk::Allocator::MemBlock &meta)
 {
-#if defined(PVK_USE_WINDOWS_ALIGNED_ALLOC)
-    _aligned_free(p);
-#else
-    free(p);
-#endif
+    return meta.vk_scope == VK_SYSTEM_ALLOCATION_SCOPE_COMMAND &&
+        pvk::host_heap::arena_fits(meta.size, meta.align);
+}
+
+static void *
+    block_alloc(const pvk::Allocator::MemBlock &meta, Placement placement)
+{
+    if (uses_arena(meta)) {
+        return pvk::host_heap::arena_alloc(meta.align, meta.size);
+    }
+
+    size_t class_idx = pvk::host_heap::class_of(meta.size, meta.align);
+    if (class_idx != pvk::host_heap::no_class) {
+        return pvk::host_heap::class_alloc(
+            pool_of(meta.vk_scope, placement.persistent),
+            placement.node,
+            class_idx);
+    }
+    return pvk::host_heap::large_alloc(meta.align, meta.size, placement.node);
+}
+
+static void block_free(
+    void *block, const pvk::Allocator::MemBlock &meta, Placement placement)
+{
+    if (uses_arena(meta)) {
+        pvk::host_heap::arena_free(block);
+        return;
+    }
+
+    size_t class_idx = pvk::host_heap::class_of(meta.size, meta.align);
+    if (class_idx != pvk::host_heap::no_class) {
+        pvk::host_heap::class_free(
+            pool_of(meta.vk_scope, placement.persistent),
+            placement.node,
+            class_idx,
+            block);
+        return;
+    }
+    pvk::host_heap::large_free(block, meta.align, meta.size);
+}
+
+/*
+ * Whether a block lands in the huge page slabs, the rest of the
+ * persistent pool (blocks above the biggest class) stays page backed
+ */
+static bool uses_huge_slab(
+    const pvk::Allocator::MemBlock &meta, Placement placement)
+{
+    return !uses_arena(meta) &&
+        pool_of(meta.vk_scope, placement.persistent) ==
+        Pool::HUGE_PERSISTENT &&
+        pvk::host_heap::class_of(meta.size, meta.align) !=
+        pvk::host_heap::no_class;
+}
+
+/*
+ * Resizes without copying when the backend allows it: slab slots while
+ * the size class and pool stay the same, arena blocks that shrink or sit
+ * on top of the caller's arena, and page backed blocks via remapping.
+ * Returns nullptr when the caller has to allocate and copy.
+ */
+
+static void *block_resize(
+    void *block,
+    const pvk::Allocator::MemBlock &old_meta,
+    const pvk::Allocator::MemBlock &new_meta,
+    Placement placement)
+{
+    if (uses_arena(old_meta) || uses_arena(new_meta)) {
+        if (!uses_arena(old_meta) || !uses_arena(new_meta)) {
+            return nullptr;
+        }
+        bool resized = pvk::host_heap::arena_resize(
+            block, new_meta.align, old_meta.size, new_meta.size);
+        return resized ? block : nullptr;
+    }
+
+    size_t old_class = pvk::host_heap::class_of(old_meta.size, old_meta.align);
+    size_t new_class = pvk::host_heap::class_of(new_meta.size, new_meta.align);
+    if (old_class != pvk::host_heap::no_class) {
+        bool same_slot = old_class == new_class &&
+            pool_of(old_meta.vk_scope, placement.persistent) ==
+                pool_of(new_meta.vk_scope, placement.persistent);
+        return same_slot ? block : nullptr;
+    }
+
+    if (new_class != pvk::host_heap::no_class ||
+        old_meta.align != new_meta.align) {
+        return nullptr;
+    }
+
+    return pvk::host_heap::large_resize(
+        block, old_meta.align, old_meta.size, new_meta.size);
 }
 
 #if defined(PVK_ALLOCATOR_ENABLE_ALIGN_MISMATCH_DEBUG)
@@ -40,20 +157,358 @@ static void
 }
 #endif
 
+/*
+ * Drivers allocate from any thread and the allocators of an instance and
+ * of its devices share one backend, so calls into a backend are
+ * serialized process wide. Backends hash to one of a few locks.
+ */
+static std::mutex &backend_lock(const std::pmr::memory_resource *backend)
+{
+    static std::array<std::mutex, 16> locks;
+    size_t addr = reinterpret_cast<size_t>(backend);
+    return locks[(addr / alignof(std::max_align_t)) % locks.size()];
+}
+
 } // namespace
 
 namespace pvk {
 
 struct Allocator::ImplFriend
 {
-    static void *VKAPI_CALL vkAllocationFunction(
-        void *allocator_p,
+    static size_t header_pad(size_t alignment)
+    {
+        size_t pad_align = std::max(alignment, alignof(BlockHeader));
+        return (sizeof(BlockHeader) + pad_align - 1) / pad_align * pad_align;
+    }
+
+    // Metadata of the backend block carrying both header and user block
+    static MemBlock header_backing(const MemBlock &meta)
+    {
+        MemBlock backing = meta;
+        backing.align = std::max(meta.align, alignof(BlockHeader));
+        size_t size = header_pad(meta.align) + meta.size;
+        backing.size =
+            (size + backing.align - 1) / backing.align * backing.align;
+        return backing;
+    }
+
+    static BlockHeader *header_of(void *block)
+    {
+        return reinterpret_cast<BlockHeader *>(block) - 1;
+    }
+
+    static Placement placement_of(Allocator *allocator)
+    {
+        Pool persistent = allocator->m_huge_pages ? Pool::HUGE_PERSISTENT
+                                                  : Pool::PERSISTENT;
+        return Placement{persistent, allocator->m_numa_node};
+    }
+
+    // Live bytes of the huge page slabs follow the user block sizes,
+    // blocks of the chunks that fell back to regular pages do not count
+    static uint64_t
+        huge_bytes(Allocator *allocator, void *block, const MemBlock &meta)
+    {
+        bool huge = uses_huge_slab(
+                        backing_meta_of(allocator, meta),
+                        placement_of(allocator)) &&
+            pvk::host_heap::in_huge_slab(backing_of(allocator, block, meta));
+        return huge ? meta.size : 0;
+    }
+
+    // Backend block and its metadata behind a user block
+    static MemBlock backing_meta_of(Allocator *allocator, const MemBlock &meta)
+    {
+        if (allocator->m_tracking == BlockTracking::REGISTRY) {
+            return meta;
+        }
+        return header_backing(meta);
+    }
+
+    static void *
+        backing_of(Allocator *allocator, void *block, const MemBlock &meta)
+    {
+        if (allocator->m_tracking == BlockTracking::REGISTRY) {
+            return block;
+        }
+        return static_cast<std::byte *>(block) - header_pad(meta.align);
+    }
+
+    static void *user_block_of(
+        Allocator *allocator, void *backing, const MemBlock &meta)
+    {
+        if (allocator->m_tracking == BlockTracking::REGISTRY) {
+            return backing;
+        }
+        return static_cast<std::byte *>(backing) + header_pad(meta.align);
+    }
+
+    // Starts tracking a user block, the header must already be in place
+    static void link(Allocator *allocator, void *block, const MemBlock &meta)
+    {
+        size_t addr = reinterpret_cast<size_t>(block);
+        Shard &shard = allocator->shard_of(addr);
+
+        if (allocator->m_tracking == BlockTracking::REGISTRY) {
+            std::lock_guard guard(shard.lock);
+            shard.blocks.emplace(addr, meta);
+            return;
+        }
+
+        BlockHeader *header = header_of(block);
+        header->meta = meta;
+        header->prev = nullptr;
+
+        std::lock_guard guard(shard.lock);
+        header->next = shard.headers;
+        if (shard.headers != nullptr) {
+            shard.headers->prev = header;
+        }
+        shard.headers = header;
+    }
+
+    // Stops tracking a user block, leaves its memory untouched
+    static std::optional<MemBlock> unlink(Allocator *allocator, void *block)
+    {
+        size_t addr = reinterpret_cast<size_t>(block);
+        Shard &shard = allocator->shard_of(addr);
+
+        if (allocator->m_tracking == BlockTracking::REGISTRY) {
+            std::lock_guard guard(shard.lock);
+            auto block_it = shard.blocks.find(addr);
+            if (block_it == std::end(shard.blocks)) {
+                return std::nullopt;
+            }
+            MemBlock meta = block_it->second;
+            shard.blocks.erase(block_it);
+            return meta;
+        }
+
+        BlockHeader *header = header_of(block);
+        std::lock_guard guard(shard.lock);
+        if (header->prev != nullptr) {
+            header->prev->next = header->next;
+        } else {
+            shard.headers = header->next;
+        }
+        if (header->next != nullptr) {
+            header->next->prev = header->prev;
+        }
+        return header->meta;
+    }
+
+    // Backend blocks: the caller's memory resource or the built-in slabs
+    static void *backend_alloc(Allocator *allocator, const MemBlock &backing)
+    {
+        if (allocator->m_backend == nullptr) {
+            return block_alloc(backing, placement_of(allocator));
+        }
+        std::lock_guard guard(backend_lock(allocator->m_backend));
+        try {
+            return allocator->m_backend->allocate(backing.size, backing.align);
+        } catch (...) {
+            return nullptr;
+        }
+    }
+
+    static void
+        backend_free(Allocator *allocator, void *block, const MemBlock &backing)
+    {
+        if (allocator->m_backend == nullptr) {
+            block_free(block, backing, placement_of(allocator));
+            return;
+        }
+        std::lock_guard guard(backend_lock(allocator->m_backend));
+        allocator->m_backend->deallocate(block, backing.size, backing.align);
+    }
+
+    static void *track_alloc(Allocator *allocator, const MemBlock &meta)
+    {
+        void *backing =
+            backend_alloc(allocator, backing_meta_of(allocator, meta));
+        if (backing == nullptr) {
+            return nullptr;
+        }
+
+        void *new_block = user_block_of(allocator, backing, meta);
+        link(allocator, new_block, meta);
+        return new_block;
+    }
+
+    static void
+        untracked_free(Allocator *allocator, void *block, const MemBlock &meta)
+    {
+        backend_free(
+            allocator,
+            backing_of(allocator, block, meta),
+            backing_meta_of(allocator, meta));
+    }
+
+    static void *track_resize(
+        Allocator *allocator,
+        void *block,
+        const MemBlock &old_meta,
+        const MemBlock &new_meta)
+    {
+        // A memory resource has no resize, the caller copies instead
+        if (allocator->m_backend != nullptr) {
+            return nullptr;
+        }
+        if (allocator->m_tracking == BlockTracking::HEADER &&
+            header_pad(old_meta.align) != header_pad(new_meta.align)) {
+            return nullptr;
+        }
+
+        void *resized = block_resize(
+            backing_of(allocator, block, old_meta),
+            backing_meta_of(allocator, old_meta),
+            backing_meta_of(allocator, new_meta),
+            placement_of(allocator));
+        if (resized == nullptr) {
+            return nullptr;
+        }
+        return user_block_of(allocator, resized, new_meta);
+    }
+
+    static size_t scope_idx(VkSystemAllocationScope scope)
+    {
+        size_t idx = static_cast<size_t>(scope);
+        if (idx >= HostMemoryStats::scope_count) {
+            return static_cast<size_t>(HostMemoryStats::Scope::OBJECT);
+        }
+        return idx;
+    }
+
+    static size_t histogram_bucket(size_t size)
+    {
+        size_t width = std::bit_width(size);
+        if (width <= 5) {
+            return 0;
+        }
+        return std::min(width - 5, HostMemoryStats::histogram_buckets - 1);
+    }
+
+    static void raise_peak(std::atomic<uint64_t> &peak, uint64_t value)
+    {
+        uint64_t current = peak.load(std::memory_order_relaxed);
+        while (current < value &&
+               !peak.compare_exchange_weak(
+                   current, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    static void grow_live(
+        Telemetry &t, ScopeTelemetry &scope, uint64_t size, uint64_t total)
+    {
+        uint64_t live =
+            scope.live_bytes.fetch_add(size, std::memory_order_relaxed);
+        raise_peak(scope.peak_bytes, live + size);
+        uint64_t total_live =
+            t.live_bytes.fetch_add(total, std::memory_order_relaxed);
+        raise_peak(t.peak_bytes, total_live + total);
+    }
+
+    static void
+        note_alloc(Allocator *allocator, void *block, const MemBlock &meta)
+    {
+        Telemetry &t = allocator->m_telemetry;
+        ScopeTelemetry &scope = t.scopes[scope_idx(meta.vk_scope)];
+        scope.allocations.fetch_add(1, std::memory_order_relaxed);
+        scope.size_histogram[histogram_bucket(meta.size)].fetch_add(
+            1, std::memory_order_relaxed);
+        grow_live(t, scope, meta.size, meta.size);
+        t.huge_page_bytes.fetch_add(
+            huge_bytes(allocator, block, meta), std::memory_order_relaxed);
+    }
+
+    static void
+        note_free(Allocator *allocator, void *block, const MemBlock &meta)
+    {
+        Telemetry &t = allocator->m_telemetry;
+        ScopeTelemetry &scope = t.scopes[scope_idx(meta.vk_scope)];
+        scope.frees.fetch_add(1, std::memory_order_relaxed);
+        scope.live_bytes.fetch_sub(meta.size, std::memory_order_relaxed);
+        t.live_bytes.fetch_sub(meta.size, std::memory_order_relaxed);
+        t.huge_page_bytes.fetch_sub(
+            huge_bytes(allocator, block, meta), std::memory_order_relaxed);
+    }
+
+    static void note_realloc(
+        Allocator *allocator,
+        void *old_block,
+        const MemBlock &old_meta,
+        void *block,
+        const MemBlock &meta)
+    {
+        Telemetry &t = allocator->m_telemetry;
+        ScopeTelemetry &old_scope = t.scopes[scope_idx(old_meta.vk_scope)];
+        ScopeTelemetry &scope = t.scopes[scope_idx(meta.vk_scope)];
+
+        old_scope.live_bytes.fetch_sub(
+            old_meta.size, std::memory_order_relaxed);
+        t.live_bytes.fetch_sub(old_meta.size, std::memory_order_relaxed);
+        t.huge_page_bytes.fetch_sub(
+            huge_bytes(allocator, old_block, old_meta),
+            std::memory_order_relaxed);
+        t.huge_page_bytes.fetch_add(
+            huge_bytes(allocator, block, meta), std::memory_order_relaxed);
+
+        scope.reallocations.fetch_add(1, std::memory_order_relaxed);
+        scope.size_histogram[histogram_bucket(meta.size)].fetch_add(
+            1, std::memory_order_relaxed);
+        grow_live(t, scope, meta.size, meta.size);
+    }
+
+    static void note_internal(
+        Allocator *allocator,
         size_t size,
-        size_t alignment,
-        VkSystemAllocationScope allocationScope)
+        VkInternalAllocationType type,
+        VkSystemAllocationScope scope,
+        bool allocated)
     {
-        Allocator *allocator = reinterpret_cast<Allocator *>(allocator_p);
+        size_t type_idx = static_cast<size_t>(type);
+        if (type_idx >= HostMemoryStats::internal_type_count) {
+            return;
+        }
+        InternalTelemetry &t =
+            allocator->m_telemetry.internal[type_idx][scope_idx(scope)];
+
+        if (!allocated) {
+            t.frees.fetch_add(1, std::memory_order_relaxed);
+            t.live_bytes.fetch_sub(size, std::memory_order_relaxed);
+            return;
+        }
 
+        t.allocations.fetch_add(1, std::memory_order_relaxed);
+        uint64_t live = t.live_bytes.fetch_add(size, std::memory_order_relaxed);
+        raise_peak(t.peak_bytes, live + size);
+    }
+
+    static void trace(
+        Allocator *allocator,
+        AllocTrace::Event event,
+        const void *block,
+        const void *original,
+        const MemBlock &meta,
+        uint64_t timestamp_ns = 0)
+    {
+        if (allocator->m_trace == nullptr) {
+            return;
+        }
+        AllocTrace::record(
+            allocator->m_trace,
+            event,
+            block,
+            original,
+            meta.size,
+            meta.align,
+            static_cast<uint8_t>(meta.vk_scope),
+            timestamp_ns);
+    }
+
+    static MemBlock make_meta(
+        size_t size, size_t alignment, VkSystemAllocationScope scope)
+    {
         size_t aligned_size = size;
 
         if (size % alignment != 0) {
@@ -63,17 +518,27 @@ struct Allocator::ImplFriend
 #endif
         }
 
-        void *new_block = aligned_alloc_wrap(alignment, aligned_size);
-        if (new_block == nullptr) {
-            return nullptr;
-        }
-
         Allocator::MemBlock new_block_meta;
         new_block_meta.align = alignment;
         new_block_meta.size = aligned_size;
-        new_block_meta.vk_scope = allocationScope;
-        size_t new_block_addr = reinterpret_cast<size_t>(new_block);
-        allocator->m_blocks.emplace(new_block_addr, new_block_meta);
+        new_block_meta.vk_scope = scope;
+        return new_block_meta;
+    }
+
+    static void *VKAPI_CALL vkAllocationFunction(
+        void *allocator_p,
+        size_t size,
+        size_t alignment,
+        VkSystemAllocationScope allocationScope)
+    {
+        Allocator *allocator = reinterpret_cast<Allocator *>(allocator_p);
+        MemBlock meta = make_meta(size, alignment, allocationScope);
+        void *new_block = track_alloc(allocator, meta);
+        if (new_block != nullptr) {
+            note_alloc(allocator, new_block, meta);
+            trace(
+                allocator, AllocTrace::Event::ALLOC, new_block, nullptr, meta);
+        }
         return new_block;
     }
 
@@ -85,17 +550,22 @@ struct Allocator::ImplFriend
 
         Allocator *allocator = reinterpret_cast<Allocator *>(allocator_p);
 
-        size_t addr_to_free = reinterpret_cast<size_t>(pMemory);
-        auto orig_block_it = allocator->m_blocks.find(addr_to_free);
-        if (orig_block_it == std::end(allocator->m_blocks)) {
+        std::optional<MemBlock> block_meta = unlink(allocator, pMemory);
+        if (!block_meta) {
             pvk::warning(
                 "VkAllocator: request freeing of nonallocated addres 0x{:x}",
-                addr_to_free);
+                reinterpret_cast<size_t>(pMemory));
             return;
         }
-
-        allocator->m_blocks.erase(orig_block_it);
-        aligned_free_wrap(pMemory);
+        // Recorded before the address can be handed out again
+        trace(
+            allocator,
+            AllocTrace::Event::FREE,
+            nullptr,
+            pMemory,
+            *block_meta);
+        untracked_free(allocator, pMemory, *block_meta);
+        note_free(allocator, pMemory, *block_meta);
     }
 
     static void *VKAPI_CALL vkReallocationFunction(
@@ -111,23 +581,60 @@ struct Allocator::ImplFriend
                 allocator_p, size, alignment, allocationScope);
         }
 
-        size_t original_addr = reinterpret_cast<size_t>(original_p);
-        auto orig_block_it = allocator->m_blocks.find(original_addr);
-        if (orig_block_it == std::end(allocator->m_blocks)) {
+        if (size == 0) {
+            vkFreeFunction(allocator_p, original_p);
+            return nullptr;
+        }
+
+        // Untracked while resizing: a remapped address may be reused
+        // by a concurrent allocation before the old record is dropped
+        std::optional<MemBlock> original_meta = unlink(allocator, original_p);
+        if (!original_meta) {
             pvk::warning(
                 "VkAllocator: reallocating of nonallocated addres 0x{:x}\n",
-                original_addr);
+                reinterpret_cast<size_t>(original_p));
             return nullptr;
         }
 
-        auto new_block =
-            vkAllocationFunction(allocator_p, size, alignment, allocationScope);
+        MemBlock new_meta = make_meta(size, alignment, allocationScope);
+
+        // A remap releases the original address, the record is stamped
+        // before anything else can be allocated there
+        uint64_t resize_time =
+            allocator->m_trace != nullptr ? AllocTrace::now() : 0;
+        void *resized =
+            track_resize(allocator, original_p, *original_meta, new_meta);
+        if (resized != nullptr) {
+            link(allocator, resized, new_meta);
+            note_realloc(
+                allocator, original_p, *original_meta, resized, new_meta);
+            trace(
+                allocator,
+                AllocTrace::Event::REALLOC,
+                resized,
+                original_p,
+                new_meta,
+                resize_time);
+            return resized;
+        }
+
+        void *new_block = track_alloc(allocator, new_meta);
         if (new_block == nullptr) {
+            link(allocator, original_p, *original_meta);
             return nullptr;
         }
 
-        std::memcpy(new_block, original_p, orig_block_it->second.size);
-        vkFreeFunction(allocator_p, original_p);
+        std::memcpy(
+            new_block, original_p, std::min(original_meta->size, size));
+        trace(
+            allocator,
+            AllocTrace::Event::REALLOC,
+            new_block,
+            original_p,
+            new_meta);
+        untracked_free(allocator, original_p, *original_meta);
+        note_realloc(
+            allocator, original_p, *original_meta, new_block, new_meta);
         return new_block;
     }
 
@@ -138,11 +645,7 @@ struct Allocator::ImplFriend
         VkSystemAllocationScope allocationScope)
     {
         Allocator *allocator = reinterpret_cast<Allocator *>(allocator_p);
-        (void)allocator;
-        (void)size;
-        (void)allocationType;
-        (void)allocationScope;
-        return;
+        note_internal(allocator, size, allocationType, allocationScope, true);
     }
 
     static void VKAPI_CALL vkInternalFreeNotification(
@@ -152,16 +655,51 @@ struct Allocator::ImplFriend
         VkSystemAllocationScope allocationScope)
     {
         Allocator *allocator = reinterpret_cast<Allocator *>(allocator_p);
-        (void)allocator;
-        (void)size;
-        (void)allocationType;
-        (void)allocationScope;
-        return;
+        note_internal(allocator, size, allocationType, allocationScope, false);
     }
 };
 
-Allocator::Allocator() noexcept
+Allocator::Options Allocator::default_options() noexcept
+{
+    const char *huge_pages = std::getenv("PVK_HOST_HUGE_PAGES");
+    return Options{
+        BlockTracking::HEADER,
+        AllocTrace::from_environment(),
+        huge_pages != nullptr && *huge_pages != '\0' &&
+            std::string_view(huge_pages) != "0",
+        any_numa_node,
+        nullptr};
+}
+
+Allocator::Allocator() noexcept : Allocator(default_options())
 {
+}
+
+Allocator::Allocator(const Options &options) noexcept
+    : m_tracking(options.tracking), m_backend(options.backend),
+      m_trace(options.trace)
+{
+    if (m_backend != nullptr) {
+        pvk::debug("VkAllocator: host blocks come from a caller backend");
+    } else if (options.huge_pages) {
+        m_huge_pages = host_heap::huge_pages_available();
+        if (!m_huge_pages) {
+            pvk::info("VkAllocator: huge pages are unavailable, "
+                      "using regular pages for persistent blocks");
+        }
+    }
+
+    if (m_backend == nullptr && options.numa_node != any_numa_node) {
+        if (!host_heap::numa_binding_supported() ||
+            !host_heap::node_bindable(options.numa_node)) {
+            pvk::info(
+                "VkAllocator: cannot bind host blocks to NUMA node {}",
+                options.numa_node);
+        } else {
+            m_numa_node = options.numa_node;
+        }
+    }
+
     m_callbacks.pUserData = this;
     m_callbacks.pfnAllocation = Allocator::ImplFriend::vkAllocationFunction;
     m_callbacks.pfnReallocation = Allocator::ImplFriend::vkReallocationFunction;
@@ -172,4 +710,80 @@ Allocator::Allocator() noexcept
     m_callbacks.pfnInternalFree =
         Allocator::ImplFriend::vkInternalFreeNotification;
 }
+
+std::unordered_map<Allocator::MemBlock::Address, Allocator::MemBlock>
+    Allocator::get_allocated_blocks()
+{
+    std::unordered_map<MemBlock::Address, MemBlock> output;
+    for (Shard &shard : m_shards) {
+        std::lock_guard guard(shard.lock);
+        output.insert(std::begin(shard.blocks), std::end(shard.blocks));
+        for (BlockHeader *header = shard.headers; header != nullptr;
+             header = header->next) {
+            size_t addr = reinterpret_cast<size_t>(header + 1);
+            output.emplace(addr, header->meta);
+        }
+    }
+    return output;
+}
+void Allocator::set_owner(std::string_view owner) noexcept
+try {
+    m_owner = owner;
+} catch (...) {
+}
+
+HostMemoryStats Allocator::snapshot() const noexcept
+{
+    constexpr auto relaxed = std::memory_order_relaxed;
+
+    HostMemoryStats output;
+    try {
+        output.owner = m_owner;
+    } catch (...) {
+    }
+
+    for (size_t scope_idx = 0; scope_idx < HostMemoryStats::scope_count;
+         scope_idx++) {
+        const ScopeTelemetry &from = m_telemetry.scopes[scope_idx];
+        HostMemoryStats::Counters &to = output.by_scope[scope_idx];
+        to.live_bytes = from.live_bytes.load(relaxed);
+        to.peak_bytes = from.peak_bytes.load(relaxed);
+        to.allocations = from.allocations.load(relaxed);
+        to.reallocations = from.reallocations.load(relaxed);
+        to.frees = from.frees.load(relaxed);
+        for (size_t bucket = 0; bucket < HostMemoryStats::histogram_buckets;
+             bucket++) {
+            to.size_histogram[bucket] =
+                from.size_histogram[bucket].load(relaxed);
+            output.total.size_histogram[bucket] += to.size_histogram[bucket];
+        }
+        output.total.allocations += to.allocations;
+        output.total.reallocations += to.reallocations;
+        output.total.frees += to.frees;
+
+        for (size_t type_idx = 0;
+             type_idx < HostMemoryStats::internal_type_count;
+             type_idx++) {
+            const InternalTelemetry &from_internal =
+                m_telemetry.internal[type_idx][scope_idx];
+            HostMemoryStats::InternalCounters &to_internal =
+                output.internal[type_idx][scope_idx];
+            to_internal.live_bytes = from_internal.live_bytes.load(relaxed);
+            to_internal.peak_bytes = from_internal.peak_bytes.load(relaxed);
+            to_internal.allocations = from_internal.allocations.load(relaxed);
+            to_internal.frees = from_internal.frees.load(relaxed);
+        }
+    }
+    output.total.live_bytes = m_telemetry.live_bytes.load(relaxed);
+    output.total.peak_bytes = m_telemetry.peak_bytes.load(relaxed);
+
+    output.numa_node = m_numa_node;
+    output.huge_page_bytes = m_telemetry.huge_page_bytes.load(relaxed);
+    host_heap::HugePageUsage huge_usage = host_heap::huge_page_usage();
+    output.process_huge_page_bytes = huge_usage.backed_bytes;
+    output.process_huge_page_fallback_bytes = huge_usage.fallback_bytes;
+
+    return output;
+}
+
 } // namespace pvk
@@ -0,0 +1,362 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "pvk/internal/alloc_trace.hh"
+#include "pvk/internal/vk_allocator.hh"
+
+/*
+ * Replays a trace recorded with PVK_ALLOCATION_TRACE against several
+ * host allocation strategies. Every strategy runs in its own child
+ * process so the reported peak RSS is not polluted by the others.
+ * Events are replayed on a single thread in timestamp order.
+ */
+
+namespace {
+
+using Record = pvk::AllocTrace::Record;
+using Event = pvk::AllocTrace::Event;
+
+std::optional<std::vector<Record>> load_trace(const std::string &path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        std::cerr << std::format("Cannot open trace \"{}\"\n", path);
+        return std::nullopt;
+    }
+
+    pvk::AllocTrace::FileHeader header{};
+    file.read(reinterpret_cast<char *>(&header), sizeof(header));
+    if (!file || header.magic != pvk::AllocTrace::magic ||
+        header.version != pvk::AllocTrace::version ||
+        header.record_size != sizeof(Record)) {
+        std::cerr << std::format(
+            "\"{}\" is not a pvk allocation trace\n", path);
+        return std::nullopt;
+    }
+
+    std::vector<Record> records;
+    Record record{};
+    while (file.read(reinterpret_cast<char *>(&record), sizeof(record))) {
+        records.emplace_back(record);
+    }
+
+    std::ranges::stable_sort(records, {}, &Record::timestamp_ns);
+    return records;
+}
+
+struct Strategy
+{
+    virtual ~Strategy() = default;
+    virtual void *alloc(size_t size, size_t alignment, uint8_t scope) = 0;
+    virtual void *realloc(
+        void *block,
+        size_t old_size,
+        size_t size,
+        size_t alignment,
+        uint8_t scope) = 0;
+    virtual void free(void *block) = 0;
+};
+
+struct PvkStrategy : Strategy
+{
+    explicit PvkStrategy(pvk::Allocator::BlockTracking tracking)
+        : allocator(pvk::Allocator::Options{
+              tracking,
+              nullptr,
+              false,
+              pvk::Allocator::any_numa_node,
+              nullptr})
+    {
+    }
+
+    void *alloc(size_t size, size_t alignment, uint8_t scope) override
+    {
+        auto cb = allocator.get_callbacks();
+        return cb->pfnAllocation(
+            cb->pUserData,
+            size,
+            alignment,
+            static_cast<VkSystemAllocationScope>(scope));
+    }
+
+    void *realloc(
+        void *block,
+        size_t /*old_size*/,
+        size_t size,
+        size_t alignment,
+        uint8_t scope) override
+    {
+        auto cb = allocator.get_callbacks();
+        return cb->pfnReallocation(
+            cb->pUserData,
+            block,
+            size,
+            alignment,
+            static_cast<VkSystemAllocationScope>(scope));
+    }
+
+    void free(void *block) override
+    {
+        auto cb = allocator.get_callbacks();
+        cb->pfnFree(cb->pUserData, block);
+    }
+
+    pvk::Allocator allocator;
+};
+
+size_t round_to(size_t size, size_t alignment)
+{
+    return (size + alignment - 1) / alignment * alignment;
+}
+
+struct MallocStrategy : Strategy
+{
+    void *alloc(size_t size, size_t alignment, uint8_t) override
+    {
+        return std::aligned_alloc(alignment, round_to(size, alignment));
+    }
+
+    void *realloc(
+        void *block,
+        size_t old_size,
+        size_t size,
+        size_t alignment,
+        uint8_t scope) override
+    {
+        void *new_block = alloc(size, alignment, scope);
+        if (new_block != nullptr) {
+            std::memcpy(new_block, block, std::min(old_size, size));
+            std::free(block);
+        }
+        return new_block;
+    }
+
+    void free(void *block) override
+    {
+        std::free(block);
+    }
+};
+
+// The original pvk allocator: one map of every block, aligned_alloc below
+struct MapStrategy : MallocStrategy
+{
+    void *alloc(size_t size, size_t alignment, uint8_t scope) override
+    {
+        void *block = MallocStrategy::alloc(size, alignment, scope);
+        if (block == nullptr) {
+            return nullptr;
+        }
+        std::lock_guard guard(lock);
+        blocks.emplace(block, size);
+        return block;
+    }
+
+    void *realloc(
+        void *block,
+        size_t old_size,
+        size_t size,
+        size_t alignment,
+        uint8_t scope) override
+    {
+        {
+            std::lock_guard guard(lock);
+            old_size = blocks.at(block);
+        }
+        void *new_block = alloc(size, alignment, scope);
+        if (new_block == nullptr) {
+            return nullptr;
+        }
+        std::memcpy(new_block, block, std::min(old_size, size));
+        free(block);
+        return new_block;
+    }
+
+    void free(void *block) override
+    {
+        {
+            std::lock_guard guard(lock);
+            blocks.erase(block);
+        }
+        MallocStrategy::free(block);
+    }
+
+    std::mutex lock;
+    std::unordered_map<void *, size_t> blocks;
+};
+
+std::unique_ptr<Strategy> make_strategy(std::string_view name)
+{
+    if (name == "map") {
+        return std::make_unique<MapStrategy>();
+    }
+    if (name == "malloc") {
+        return std::make_unique<MallocStrategy>();
+    }
+    if (name == "pvk-registry") {
+        return std::make_unique<PvkStrategy>(
+            pvk::Allocator::BlockTracking::REGISTRY);
+    }
+    return std::make_unique<PvkStrategy>(pvk::Allocator::BlockTracking::HEADER);
+}
+
+size_t peak_rss_bytes()
+{
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return static_cast<size_t>(usage.ru_maxrss) * 1024;
+}
+
+void replay(std::string_view name, const std::vector<Record> &records)
+{
+    struct LiveBlock
+    {
+        void *block;
+        size_t size;
+    };
+
+    std::unordered_map<uint64_t, LiveBlock> live;
+    live.reserve(records.size());
+    auto strategy = make_strategy(name);
+
+    size_t rss_before = peak_rss_bytes();
+    size_t live_bytes = 0;
+    size_t peak_live_bytes = 0;
+    size_t unmatched = 0;
+    // Allocations the strategy could not serve, the trace goes on without
+    size_t failed = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (const Record &r : records) {
+        size_t alignment = size_t(1) << r.align_log2;
+        switch (r.event) {
+        case Event::ALLOC: {
+            void *block = strategy->alloc(r.size, alignment, r.scope);
+            if (block == nullptr) {
+                failed++;
+                break;
+            }
+            std::memset(block, 0, r.size);
+            live[r.block] = {block, r.size};
+            live_bytes += r.size;
+            break;
+        }
+        case Event::FREE: {
+            auto it = live.find(r.original);
+            if (it == std::end(live)) {
+                unmatched++;
+                break;
+            }
+            strategy->free(it->second.block);
+            live_bytes -= it->second.size;
+            live.erase(it);
+            break;
+        }
+        case Event::REALLOC: {
+            auto it = live.find(r.original);
+            if (it == std::end(live)) {
+                unmatched++;
+                break;
+            }
+            LiveBlock old = it->second;
+            live.erase(it);
+            void *block = strategy->realloc(
+                old.block, old.size, r.size, alignment, r.scope);
+            if (block == nullptr) {
+                // The original block is left as it was
+                failed++;
+                live[r.original] = old;
+                break;
+            }
+            if (r.size > old.size) {
+                std::memset(
+                    static_cast<std::byte *>(block) + old.size,
+                    0,
+                    r.size - old.size);
+            }
+            live[r.block] = {block, r.size};
+            live_bytes = live_bytes - old.size + r.size;
+            break;
+        }
+        }
+        peak_live_bytes = std::max(peak_live_bytes, live_bytes);
+    }
+    auto stop = std::chrono::steady_clock::now();
+
+    size_t rss_growth = peak_rss_bytes() - rss_before;
+    for (auto &entry : live) {
+        strategy->free(entry.second.block);
+    }
+
+    double seconds = std::chrono::duration<double>(stop - start).count();
+    double fragmentation = peak_live_bytes == 0
+        ? 0.0
+        : static_cast<double>(rss_growth) / peak_live_bytes;
+
+    std::cout << std::format(
+        "{:<14} {:>10.2f} Mevents/s  peak RSS +{:>8} KiB  "
+        "peak live {:>8} KiB  RSS/live {:>5.2f}  unmatched {}  "
+        "failed {}\n",
+        name,
+        records.size() / seconds / 1e6,
+        rss_growth / 1024,
+        peak_live_bytes / 1024,
+        fragmentation,
+        unmatched,
+        failed);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    if (argc < 2) {
+        std::cerr << std::format("Usage: {} <trace file>\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    auto records = load_trace(argv[1]);
+    if (!records) {
+        return EXIT_FAILURE;
+    }
+    std::cout << std::format("Replaying {} events\n", records->size());
+
+    constexpr std::string_view strategies[] = {
+        "map", "malloc", "pvk-registry", "pvk-header"};
+
+    for (std::string_view name : strategies) {
+        std::cout.flush();
+        pid_t child = fork();
+        if (child == 0) {
+            replay(name, *records);
+            std::cout.flush();
+            std::_Exit(EXIT_SUCCESS);
+        }
+        if (child < 0) {
+            std::cerr << "fork failed\n";
+            return EXIT_FAILURE;
+        }
+        int status = 0;
+        waitpid(child, &status, 0);
+    }
+
+    return EXIT_SUCCESS;
+}
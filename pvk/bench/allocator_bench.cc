@@ -0,0 +1,167 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <format>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+#include "pvk/internal/vk_allocator.hh"
+
+/*
+ * Driver-like host allocation load: every thread keeps a window of live
+ * blocks and replaces a random one per step. Most requests are small
+ * object-sized blocks, a few are large cache-sized ones.
+ */
+
+namespace {
+
+constexpr size_t ops_per_thread = 200000;
+constexpr size_t live_window = 64;
+constexpr std::array<size_t, 7> thread_counts{1, 2, 4, 8, 16, 32, 64};
+
+struct Request
+{
+    size_t size;
+    size_t alignment;
+    VkSystemAllocationScope scope;
+};
+
+std::vector<Request> make_requests(uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<size_t> small_size(8, 512);
+    std::uniform_int_distribution<size_t> large_size(4096, 64 * 1024);
+    std::uniform_int_distribution<int> pick(0, 99);
+    constexpr std::array<size_t, 4> alignments{8, 16, 32, 64};
+    constexpr std::array<VkSystemAllocationScope, 4> scopes{
+        VK_SYSTEM_ALLOCATION_SCOPE_COMMAND,
+        VK_SYSTEM_ALLOCATION_SCOPE_OBJECT,
+        VK_SYSTEM_ALLOCATION_SCOPE_OBJECT,
+        VK_SYSTEM_ALLOCATION_SCOPE_DEVICE,
+    };
+
+    std::vector<Request> output(ops_per_thread);
+    for (auto &request : output) {
+        request.size = pick(rng) < 97 ? small_size(rng) : large_size(rng);
+        request.alignment = alignments[pick(rng) % alignments.size()];
+        request.scope = scopes[pick(rng) % scopes.size()];
+    }
+    return output;
+}
+
+template <pvk::Allocator::BlockTracking TRACKING>
+struct PvkStrategy
+{
+    static constexpr std::string_view name =
+        TRACKING == pvk::Allocator::BlockTracking::HEADER
+        ? "pvk::Allocator header"
+        : "pvk::Allocator registry";
+
+    void *alloc(const Request &r)
+    {
+        auto cb = allocator.get_callbacks();
+        return cb->pfnAllocation(
+            cb->pUserData,
+            r.size,
+            r.alignment,
+            r.scope);
+    }
+
+    void free(void *p)
+    {
+        auto cb = allocator.get_callbacks();
+        cb->pfnFree(cb->pUserData, p);
+    }
+
+    pvk::Allocator allocator{pvk::Allocator::Options{
+        TRACKING,
+        nullptr,
+        false,
+        pvk::Allocator::any_numa_node,
+        nullptr}};
+};
+
+struct AlignedAllocStrategy
+{
+    static constexpr std::string_view name = "std::aligned_alloc";
+
+    void *alloc(const Request &r)
+    {
+        size_t size = (r.size + r.alignment - 1) / r.alignment * r.alignment;
+        return std::aligned_alloc(r.alignment, size);
+    }
+
+    void free(void *p)
+    {
+        std::free(p);
+    }
+};
+
+template <typename Strategy>
+void worker(Strategy &strategy, const std::vector<Request> &requests)
+{
+    std::array<void *, live_window> live{};
+    size_t slot = 0;
+    for (const Request &request : requests) {
+        slot = (slot * 7 + request.size) % live_window;
+        if (live[slot] != nullptr) {
+            strategy.free(live[slot]);
+        }
+        live[slot] = strategy.alloc(request);
+    }
+    for (void *block : live) {
+        if (block != nullptr) {
+            strategy.free(block);
+        }
+    }
+}
+
+template <typename Strategy>
+void run()
+{
+    for (size_t nb_threads : thread_counts) {
+        auto strategy = std::make_unique<Strategy>();
+
+        std::vector<std::vector<Request>> requests;
+        for (size_t thread_idx = 0; thread_idx < nb_threads; thread_idx++) {
+            requests.emplace_back(make_requests(thread_idx + 1));
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> threads;
+        for (size_t thread_idx = 0; thread_idx < nb_threads; thread_idx++) {
+            threads.emplace_back(
+                worker<Strategy>,
+                std::ref(*strategy),
+                std::cref(requests[thread_idx]));
+        }
+        std::ranges::for_each(threads, [](auto &t) { t.join(); });
+        auto stop = std::chrono::steady_clock::now();
+
+        double seconds = std::chrono::duration<double>(stop - start).count();
+        double mops = nb_threads * ops_per_thread / seconds / 1e6;
+        std::cout << std::format(
+            "{:<24} {:>3} threads: {:>8.2f} Mops/s\n",
+            Strategy::name,
+            nb_threads,
+            mops);
+    }
+}
+
+} // namespace
+
+int main()
+{
+    run<PvkStrategy<pvk::Allocator::BlockTracking::HEADER>>();
+    run<PvkStrategy<pvk::Allocator::BlockTracking::REGISTRY>>();
+    run<AlignedAllocStrategy>();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,349 @@
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <format>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string_view>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+#include "pvk/internal/bindless_table.hh"
+#include "pvk/internal/descriptor_cache.hh"
+#include "pvk/internal/physical_device_info.hh"
+#include "pvk/internal/timeline.hh"
+#include "pvk/internal/vk_api.hh"
+
+/*
+ * Dispatches reading a few storage buffers out of many. The driver is a
+ * stub with a fixed cost per call and per descriptor written. Compares a
+ * set allocated, written and bound for every dispatch, the same through
+ * DescriptorCache when dispatches repeat their bindings, and the bindless
+ * table bound once per command buffer with indices pushed per dispatch.
+ */
+
+namespace {
+
+constexpr size_t frames = 20;
+constexpr size_t dispatches_per_frame = 2000;
+constexpr size_t buffers_per_dispatch = 4;
+constexpr size_t nb_buffers = 256;
+// Distinct bindings per frame when dispatches repeat them
+constexpr size_t repeated_bindings = 32;
+
+constexpr auto call_overhead = std::chrono::nanoseconds(100);
+constexpr auto allocate_cost = std::chrono::nanoseconds(300);
+constexpr auto descriptor_cost = std::chrono::nanoseconds(80);
+
+std::atomic<uintptr_t> next_handle{1};
+
+void spin_for(std::chrono::nanoseconds duration)
+{
+    auto until = std::chrono::steady_clock::now() + duration;
+    while (std::chrono::steady_clock::now() < until) {
+    }
+}
+
+template <typename Handle> Handle fake_handle()
+{
+    return reinterpret_cast<Handle>(next_handle.fetch_add(1));
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL stub_create_set_layout(
+    VkDevice,
+    const VkDescriptorSetLayoutCreateInfo *,
+    const VkAllocationCallbacks *,
+    VkDescriptorSetLayout *layout)
+{
+    *layout = fake_handle<VkDescriptorSetLayout>();
+    return VK_SUCCESS;
+}
+
+VKAPI_ATTR void VKAPI_CALL stub_destroy_set_layout(
+    VkDevice, VkDescriptorSetLayout, const VkAllocationCallbacks *)
+{
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL stub_create_pipeline_layout(
+    VkDevice,
+    const VkPipelineLayoutCreateInfo *,
+    const VkAllocationCallbacks *,
+    VkPipelineLayout *layout)
+{
+    *layout = fake_handle<VkPipelineLayout>();
+    return VK_SUCCESS;
+}
+
+VKAPI_ATTR void VKAPI_CALL stub_destroy_pipeline_layout(
+    VkDevice, VkPipelineLayout, const VkAllocationCallbacks *)
+{
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL stub_create_pool(
+    VkDevice,
+    const VkDescriptorPoolCreateInfo *,
+    const VkAllocationCallbacks *,
+    VkDescriptorPool *pool)
+{
+    spin_for(call_overhead);
+    *pool = fake_handle<VkDescriptorPool>();
+    return VK_SUCCESS;
+}
+
+VKAPI_ATTR void VKAPI_CALL stub_destroy_pool(
+    VkDevice, VkDescriptorPool, const VkAllocationCallbacks *)
+{
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL
+    stub_reset_pool(VkDevice, VkDescriptorPool, VkDescriptorPoolResetFlags)
+{
+    spin_for(call_overhead);
+    return VK_SUCCESS;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL stub_allocate_sets(
+    VkDevice, const VkDescriptorSetAllocateInfo *info, VkDescriptorSet *sets)
+{
+    spin_for(allocate_cost);
+    for (uint32_t idx = 0; idx < info->descriptorSetCount; idx++) {
+        sets[idx] = fake_handle<VkDescriptorSet>();
+    }
+    return VK_SUCCESS;
+}
+
+VKAPI_ATTR void VKAPI_CALL stub_update_sets(
+    VkDevice,
+    uint32_t nb_writes,
+    const VkWriteDescriptorSet *,
+    uint32_t,
+    const VkCopyDescriptorSet *)
+{
+    spin_for(call_overhead + descriptor_cost * nb_writes);
+}
+
+VKAPI_ATTR void VKAPI_CALL stub_bind_sets(
+    VkCommandBuffer,
+    VkPipelineBindPoint,
+    VkPipelineLayout,
+    uint32_t,
+    uint32_t,
+    const VkDescriptorSet *,
+    uint32_t,
+    const uint32_t *)
+{
+    spin_for(call_overhead);
+}
+
+VKAPI_ATTR void VKAPI_CALL stub_push_constants(
+    VkCommandBuffer,
+    VkPipelineLayout,
+    VkShaderStageFlags,
+    uint32_t,
+    uint32_t,
+    const void *)
+{
+    spin_for(call_overhead / 4);
+}
+
+VKAPI_ATTR void VKAPI_CALL
+    stub_dispatch(VkCommandBuffer, uint32_t, uint32_t, uint32_t)
+{
+    spin_for(call_overhead);
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL stub_create_semaphore(
+    VkDevice,
+    const VkSemaphoreCreateInfo *,
+    const VkAllocationCallbacks *,
+    VkSemaphore *semaphore)
+{
+    *semaphore = fake_handle<VkSemaphore>();
+    return VK_SUCCESS;
+}
+
+// Every frame completes as soon as it is retired
+VKAPI_ATTR VkResult VKAPI_CALL
+    stub_semaphore_counter(VkDevice, VkSemaphore, uint64_t *value)
+{
+    *value = UINT64_MAX;
+    return VK_SUCCESS;
+}
+
+using Binding = std::array<uint32_t, buffers_per_dispatch>;
+
+VkBuffer buffer_of(uint32_t idx)
+{
+    return reinterpret_cast<VkBuffer>(uintptr_t{0x10000} + idx);
+}
+
+// Buffers used by each dispatch of a frame
+std::vector<Binding> frame_bindings(std::mt19937 &random, size_t distinct)
+{
+    std::uniform_int_distribution<uint32_t> pick(0, nb_buffers - 1);
+    std::vector<Binding> unique(distinct);
+    for (Binding &binding : unique) {
+        for (uint32_t &buffer : binding) {
+            buffer = pick(random);
+        }
+    }
+    std::vector<Binding> bindings(dispatches_per_frame);
+    for (size_t idx = 0; idx < bindings.size(); idx++) {
+        bindings[idx] = unique[idx % distinct];
+    }
+    return bindings;
+}
+
+struct DescriptorSetStrategy
+{
+    DescriptorSetStrategy(std::string_view strategy_name, size_t distinct)
+        : name(strategy_name), distinct_bindings(distinct)
+    {
+        std::array<VkDescriptorSetLayoutBinding, buffers_per_dispatch>
+            bindings{};
+        for (uint32_t idx = 0; idx < buffers_per_dispatch; idx++) {
+            bindings[idx].binding = idx;
+            bindings[idx].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            bindings[idx].descriptorCount = 1;
+            bindings[idx].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        }
+        layout = cache.layout(bindings);
+    }
+
+    void begin_frame()
+    {
+    }
+
+    void dispatch(const Binding &binding)
+    {
+        std::array<pvk::DescriptorWrite, buffers_per_dispatch> writes{};
+        for (uint32_t idx = 0; idx < buffers_per_dispatch; idx++) {
+            writes[idx].binding = idx;
+            writes[idx].buffer.buffer = buffer_of(binding[idx]);
+            writes[idx].buffer.range = VK_WHOLE_SIZE;
+        }
+        VkDescriptorSet set = cache.set(layout, writes);
+        vkCmdBindDescriptorSets(
+            VK_NULL_HANDLE,
+            VK_PIPELINE_BIND_POINT_COMPUTE,
+            VK_NULL_HANDLE,
+            0,
+            1,
+            &set,
+            0,
+            nullptr);
+        vkCmdDispatch(VK_NULL_HANDLE, 1, 1, 1);
+    }
+
+    void end_frame(uint64_t frame)
+    {
+        cache.retire(timeline, frame);
+    }
+
+    std::string_view name;
+    size_t distinct_bindings;
+    pvk::DescriptorCache cache{VK_NULL_HANDLE, nullptr};
+    VkDescriptorSetLayout layout = VK_NULL_HANDLE;
+    std::shared_ptr<pvk::Timeline> timeline = pvk::Timeline::create(
+        VK_NULL_HANDLE, true, nullptr, nullptr, "bench");
+};
+
+struct BindlessStrategy
+{
+    BindlessStrategy()
+    {
+        pvk::PhysicalDeviceInfo info;
+        info.api_version = VK_API_VERSION_1_2;
+        info.properties.limits.maxPushConstantsSize = 128;
+        VkPhysicalDeviceVulkan12Properties &limits = info.properties_12;
+        limits.maxPerStageDescriptorUpdateAfterBindStorageBuffers = 1 << 20;
+        limits.maxDescriptorSetUpdateAfterBindStorageBuffers = 1 << 20;
+        limits.maxPerStageUpdateAfterBindResources = 1 << 20;
+        table = pvk::BindlessTable::create(VK_NULL_HANDLE, info, nullptr);
+        for (uint32_t idx = 0; idx < nb_buffers; idx++) {
+            indices[idx] = table->add_buffer(buffer_of(idx));
+        }
+    }
+
+    void begin_frame()
+    {
+        table->bind(VK_NULL_HANDLE, VK_PIPELINE_BIND_POINT_COMPUTE);
+    }
+
+    void dispatch(const Binding &binding)
+    {
+        std::array<uint32_t, buffers_per_dispatch> pushed;
+        for (uint32_t idx = 0; idx < buffers_per_dispatch; idx++) {
+            pushed[idx] = indices[binding[idx]];
+        }
+        table->push(VK_NULL_HANDLE, pushed);
+        vkCmdDispatch(VK_NULL_HANDLE, 1, 1, 1);
+    }
+
+    void end_frame(uint64_t)
+    {
+    }
+
+    std::string_view name = "bindless table";
+    size_t distinct_bindings = dispatches_per_frame;
+    std::unique_ptr<pvk::BindlessTable> table;
+    std::array<uint32_t, nb_buffers> indices{};
+};
+
+template <typename Strategy> void run(Strategy &strategy)
+{
+    std::mt19937 random(42);
+    std::vector<std::vector<Binding>> bindings;
+    for (size_t frame = 0; frame < frames; frame++) {
+        bindings.emplace_back(
+            frame_bindings(random, strategy.distinct_bindings));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t frame = 0; frame < frames; frame++) {
+        strategy.begin_frame();
+        for (const Binding &binding : bindings[frame]) {
+            strategy.dispatch(binding);
+        }
+        strategy.end_frame(frame + 1);
+    }
+    auto stop = std::chrono::steady_clock::now();
+
+    double seconds = std::chrono::duration<double>(stop - start).count();
+    double kdispatches = frames * dispatches_per_frame / seconds / 1e3;
+    std::cout << std::format(
+        "{:<28} {:>8.1f} Kdispatches/s\n", strategy.name, kdispatches);
+}
+
+} // namespace
+
+int main()
+{
+    vkCreateDescriptorSetLayout = stub_create_set_layout;
+    vkDestroyDescriptorSetLayout = stub_destroy_set_layout;
+    vkCreatePipelineLayout = stub_create_pipeline_layout;
+    vkDestroyPipelineLayout = stub_destroy_pipeline_layout;
+    vkCreateDescriptorPool = stub_create_pool;
+    vkDestroyDescriptorPool = stub_destroy_pool;
+    vkResetDescriptorPool = stub_reset_pool;
+    vkAllocateDescriptorSets = stub_allocate_sets;
+    vkUpdateDescriptorSets = stub_update_sets;
+    vkCmdBindDescriptorSets = stub_bind_sets;
+    vkCmdPushConstants = stub_push_constants;
+    vkCmdDispatch = stub_dispatch;
+    vkCreateSemaphore = stub_create_semaphore;
+    vkGetSemaphoreCounterValue = stub_semaphore_counter;
+
+    DescriptorSetStrategy per_dispatch(
+        "set per dispatch", dispatches_per_frame);
+    run(per_dispatch);
+    DescriptorSetStrategy repeated("cached sets, repeated", repeated_bindings);
+    run(repeated);
+    BindlessStrategy bindless;
+    run(bindless);
+    return EXIT_SUCCESS;
+}
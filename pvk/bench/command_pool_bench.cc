@@ -0,0 +1,252 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <barrier>
+#include <chrono>
+#include <cstdlib>
+#include <format>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+#include "pvk/internal/command_pools.hh"
+#include "pvk/internal/timeline.hh"
+#include "pvk/internal/vk_api.hh"
+
+/*
+ * Frames of command buffers recorded by many threads. The driver is a
+ * stub with a fixed cost per call and per recorded buffer. Compares one
+ * pool shared under a lock, where buffers are freed one by one after the
+ * frame, against per thread CommandPools reset whole once the frame
+ * completes.
+ */
+
+namespace {
+
+constexpr size_t frames = 50;
+constexpr size_t buffers_per_frame = 64;
+constexpr std::array<size_t, 5> thread_counts{1, 2, 4, 8, 16};
+constexpr auto call_overhead = std::chrono::nanoseconds(300);
+constexpr auto recording_cost = std::chrono::nanoseconds(2000);
+
+std::atomic<uintptr_t> next_handle{1};
+
+void spin_for(std::chrono::nanoseconds duration)
+{
+    auto until = std::chrono::steady_clock::now() + duration;
+    while (std::chrono::steady_clock::now() < until) {
+    }
+}
+
+template <typename Handle> Handle fake_handle()
+{
+    return reinterpret_cast<Handle>(next_handle.fetch_add(1));
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL stub_create_command_pool(
+    VkDevice,
+    const VkCommandPoolCreateInfo *,
+    const VkAllocationCallbacks *,
+    VkCommandPool *pool)
+{
+    spin_for(call_overhead);
+    *pool = fake_handle<VkCommandPool>();
+    return VK_SUCCESS;
+}
+
+VKAPI_ATTR void VKAPI_CALL stub_destroy_command_pool(
+    VkDevice, VkCommandPool, const VkAllocationCallbacks *)
+{
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL stub_allocate_command_buffers(
+    VkDevice,
+    const VkCommandBufferAllocateInfo *info,
+    VkCommandBuffer *buffers)
+{
+    spin_for(call_overhead);
+    for (uint32_t idx = 0; idx < info->commandBufferCount; idx++) {
+        buffers[idx] = fake_handle<VkCommandBuffer>();
+    }
+    return VK_SUCCESS;
+}
+
+VKAPI_ATTR void VKAPI_CALL stub_free_command_buffers(
+    VkDevice, VkCommandPool, uint32_t, const VkCommandBuffer *)
+{
+    spin_for(call_overhead);
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL
+    stub_begin_command_buffer(VkCommandBuffer, const VkCommandBufferBeginInfo *)
+{
+    return VK_SUCCESS;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL stub_end_command_buffer(VkCommandBuffer)
+{
+    return VK_SUCCESS;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL
+    stub_reset_command_pool(VkDevice, VkCommandPool, VkCommandPoolResetFlags)
+{
+    spin_for(call_overhead);
+    return VK_SUCCESS;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL stub_create_semaphore(
+    VkDevice,
+    const VkSemaphoreCreateInfo *,
+    const VkAllocationCallbacks *,
+    VkSemaphore *semaphore)
+{
+    *semaphore = fake_handle<VkSemaphore>();
+    return VK_SUCCESS;
+}
+
+// Every frame completes as soon as it is retired
+VKAPI_ATTR VkResult VKAPI_CALL
+    stub_semaphore_counter(VkDevice, VkSemaphore, uint64_t *value)
+{
+    *value = UINT64_MAX;
+    return VK_SUCCESS;
+}
+
+void record(VkCommandBuffer buffer)
+{
+    spin_for(recording_cost);
+    vkEndCommandBuffer(buffer);
+}
+
+struct SharedPoolStrategy
+{
+    static constexpr std::string_view name = "shared pool + mutex";
+
+    SharedPoolStrategy(size_t nb_threads) : frame_buffers(nb_threads)
+    {
+        VkCommandPoolCreateInfo create_info{};
+        vkCreateCommandPool(VK_NULL_HANDLE, &create_info, nullptr, &pool);
+    }
+
+    void record_one(size_t thread_idx)
+    {
+        VkCommandBufferAllocateInfo allocate_info{};
+        allocate_info.commandPool = pool;
+        allocate_info.commandBufferCount = 1;
+        VkCommandBufferBeginInfo begin_info{};
+
+        // The pool is externally synchronized for the whole recording
+        std::lock_guard guard(lock);
+        VkCommandBuffer buffer = VK_NULL_HANDLE;
+        vkAllocateCommandBuffers(VK_NULL_HANDLE, &allocate_info, &buffer);
+        vkBeginCommandBuffer(buffer, &begin_info);
+        record(buffer);
+        frame_buffers[thread_idx].emplace_back(buffer);
+    }
+
+    void end_frame(size_t thread_idx)
+    {
+        std::lock_guard guard(lock);
+        for (VkCommandBuffer buffer : frame_buffers[thread_idx]) {
+            vkFreeCommandBuffers(VK_NULL_HANDLE, pool, 1, &buffer);
+        }
+        frame_buffers[thread_idx].clear();
+    }
+
+    void retire(uint64_t)
+    {
+    }
+
+    std::mutex lock;
+    VkCommandPool pool = VK_NULL_HANDLE;
+    std::vector<std::vector<VkCommandBuffer>> frame_buffers;
+};
+
+struct ThreadPoolsStrategy
+{
+    static constexpr std::string_view name = "pvk::CommandPools";
+
+    ThreadPoolsStrategy(size_t)
+    {
+    }
+
+    void record_one(size_t)
+    {
+        record(pools.primary(0));
+    }
+
+    void end_frame(size_t)
+    {
+    }
+
+    void retire(uint64_t frame)
+    {
+        pools.retire(0, timeline, frame);
+    }
+
+    pvk::CommandPools pools{VK_NULL_HANDLE, 1, nullptr};
+    std::shared_ptr<pvk::Timeline> timeline = pvk::Timeline::create(
+        VK_NULL_HANDLE, true, nullptr, nullptr, "bench");
+};
+
+template <typename Strategy>
+void run()
+{
+    for (size_t nb_threads : thread_counts) {
+        auto strategy = std::make_unique<Strategy>(nb_threads);
+        uint64_t frame = 0;
+        std::barrier frame_end(static_cast<std::ptrdiff_t>(nb_threads), [&]() {
+            strategy->retire(++frame);
+        });
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> threads;
+        for (size_t thread_idx = 0; thread_idx < nb_threads; thread_idx++) {
+            threads.emplace_back([&strategy, &frame_end, thread_idx]() {
+                for (size_t frame_idx = 0; frame_idx < frames; frame_idx++) {
+                    for (size_t idx = 0; idx < buffers_per_frame; idx++) {
+                        strategy->record_one(thread_idx);
+                    }
+                    strategy->end_frame(thread_idx);
+                    frame_end.arrive_and_wait();
+                }
+            });
+        }
+        std::ranges::for_each(threads, [](auto &t) { t.join(); });
+        auto stop = std::chrono::steady_clock::now();
+
+        double seconds = std::chrono::duration<double>(stop - start).count();
+        double kbuffers =
+            nb_threads * frames * buffers_per_frame / seconds / 1e3;
+        std::cout << std::format(
+            "{:<24} {:>3} threads: {:>8.1f} Kbuffers/s\n",
+            Strategy::name,
+            nb_threads,
+            kbuffers);
+    }
+}
+
+} // namespace
+
+int main()
+{
+    vkCreateCommandPool = stub_create_command_pool;
+    vkDestroyCommandPool = stub_destroy_command_pool;
+    vkAllocateCommandBuffers = stub_allocate_command_buffers;
+    vkFreeCommandBuffers = stub_free_command_buffers;
+    vkBeginCommandBuffer = stub_begin_command_buffer;
+    vkEndCommandBuffer = stub_end_command_buffer;
+    vkResetCommandPool = stub_reset_command_pool;
+    vkCreateSemaphore = stub_create_semaphore;
+    vkGetSemaphoreCounterValue = stub_semaphore_counter;
+    run<SharedPoolStrategy>();
+    run<ThreadPoolsStrategy>();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,191 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <pthread.h>
+#include <sched.h>
+
+#include "pvk/internal/numa.hh"
+#include "pvk/internal/vk_allocator.hh"
+
+/*
+ * Submit-heavy loop over driver-like host memory: the device state is
+ * created once by a thread on a remote node, then submitter threads
+ * pinned to the device node walk part of it and churn transient
+ * per-submit blocks. Without a NUMA binding the device state stays on
+ * the node that created it; with the binding it follows the device.
+ */
+
+namespace {
+
+constexpr size_t submits_per_thread = 200000;
+constexpr size_t max_threads = 8;
+constexpr size_t device_blocks = 4096;
+constexpr size_t device_block_size = 1024;
+constexpr size_t touched_per_submit = 8;
+
+std::vector<int> node_cpus(int node)
+{
+    std::ifstream cpulist(
+        std::format("/sys/devices/system/node/node{}/cpulist", node));
+    std::string list;
+    std::getline(cpulist, list);
+
+    std::vector<int> output;
+    std::stringstream ranges(list);
+    std::string range;
+    while (std::getline(ranges, range, ',')) {
+        size_t dash = range.find('-');
+        int first = std::stoi(range.substr(0, dash));
+        int last = dash == std::string::npos
+            ? first
+            : std::stoi(range.substr(dash + 1));
+        for (int cpu = first; cpu <= last; cpu++) {
+            output.emplace_back(cpu);
+        }
+    }
+    return output;
+}
+
+void pin_to(const std::vector<int> &cpus)
+{
+    if (cpus.empty()) {
+        return;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus) {
+        CPU_SET(cpu, &set);
+    }
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+}
+
+struct DeviceState
+{
+    std::vector<void *> blocks;
+};
+
+void *alloc(pvk::Allocator &allocator, size_t size, VkSystemAllocationScope s)
+{
+    auto cb = allocator.get_callbacks();
+    return cb->pfnAllocation(cb->pUserData, size, 64, s);
+}
+
+void release(pvk::Allocator &allocator, void *block)
+{
+    auto cb = allocator.get_callbacks();
+    cb->pfnFree(cb->pUserData, block);
+}
+
+uint64_t submitter(pvk::Allocator &allocator, DeviceState &state, size_t seed)
+{
+    uint64_t checksum = 0;
+    size_t cursor = seed * 131;
+    for (size_t submit = 0; submit < submits_per_thread; submit++) {
+        // Fence and submit info objects plus command scoped scratch
+        void *fence = alloc(allocator, 192, VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+        void *scratch =
+            alloc(allocator, 512, VK_SYSTEM_ALLOCATION_SCOPE_COMMAND);
+        std::memset(fence, 0, 192);
+        std::memset(scratch, 0, 512);
+
+        // Queue and descriptor state the driver reads on every submit,
+        // shared by all submitters
+        for (size_t touch = 0; touch < touched_per_submit; touch++) {
+            cursor = (cursor * 1103515245 + 12345) % device_blocks;
+            auto *words = static_cast<uint64_t *>(state.blocks[cursor]);
+            for (size_t word = 0; word < device_block_size / 8; word += 8) {
+                checksum += words[word];
+            }
+        }
+
+        release(allocator, scratch);
+        release(allocator, fence);
+    }
+    return checksum;
+}
+
+double run(int thread_node, int creator_node, int bound_node)
+{
+    pvk::Allocator allocator(pvk::Allocator::Options{
+        pvk::Allocator::BlockTracking::HEADER,
+        nullptr,
+        false,
+        bound_node,
+        nullptr});
+
+    DeviceState state;
+    std::thread creator([&]() {
+        pin_to(node_cpus(creator_node));
+        for (size_t block_idx = 0; block_idx < device_blocks; block_idx++) {
+            void *block = alloc(
+                allocator,
+                device_block_size,
+                VK_SYSTEM_ALLOCATION_SCOPE_DEVICE);
+            std::memset(block, 1, device_block_size);
+            state.blocks.emplace_back(block);
+        }
+    });
+    creator.join();
+
+    std::vector<int> cpus = node_cpus(thread_node);
+    size_t nb_threads = std::clamp<size_t>(cpus.size(), 1, max_threads);
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<uint64_t> checksums(nb_threads);
+    std::vector<std::thread> threads;
+    for (size_t thread_idx = 0; thread_idx < nb_threads; thread_idx++) {
+        threads.emplace_back([&, thread_idx]() {
+            pin_to(cpus);
+            checksums[thread_idx] =
+                submitter(allocator, state, thread_idx + 1);
+        });
+    }
+    std::ranges::for_each(threads, [](auto &t) { t.join(); });
+    auto stop = std::chrono::steady_clock::now();
+
+    for (void *block : state.blocks) {
+        release(allocator, block);
+    }
+
+    double seconds = std::chrono::duration<double>(stop - start).count();
+    return nb_threads * submits_per_thread / seconds / 1e6;
+}
+
+} // namespace
+
+int main()
+{
+    int nodes = static_cast<int>(pvk::numa::node_count());
+    if (nodes < 2) {
+        std::cout << "Single NUMA node: binding cannot change placement, "
+                     "results show the binding overhead only\n";
+    }
+
+    for (int device_node = 0; device_node < nodes; device_node++) {
+        int remote_node = (device_node + 1) % nodes;
+        double unbound = run(device_node, remote_node, -1);
+        double bound = run(device_node, remote_node, device_node);
+        std::cout << std::format(
+            "device node {} (state created on node {}): "
+            "unbound {:>6.2f} Msubmits/s, bound {:>6.2f} Msubmits/s "
+            "({:+.1f}%)\n",
+            device_node,
+            remote_node,
+            unbound,
+            bound,
+            (bound / unbound - 1.0) * 100.0);
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,161 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <format>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+#include "pvk/internal/submit_ring.hh"
+#include "pvk/internal/timeline.hh"
+#include "pvk/internal/vk_api.hh"
+
+/*
+ * Many threads submitting small command buffers to one queue. The driver
+ * is replaced by a stub whose vkQueueSubmit costs a fixed overhead per
+ * call plus a little per command buffer, which is the part batching
+ * amortizes. Compares one locked vkQueueSubmit per submission against
+ * the SubmitRing, whose timeline signal rides along each batch.
+ */
+
+namespace {
+
+constexpr size_t submits_per_thread = 20000;
+constexpr std::array<size_t, 5> thread_counts{1, 2, 4, 8, 16};
+constexpr auto call_overhead = std::chrono::nanoseconds(2000);
+constexpr auto command_buffer_cost = std::chrono::nanoseconds(100);
+
+std::atomic<uint64_t> driver_command_buffers{0};
+
+void spin_for(std::chrono::nanoseconds duration)
+{
+    auto until = std::chrono::steady_clock::now() + duration;
+    while (std::chrono::steady_clock::now() < until) {
+    }
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL stub_queue_submit(
+    VkQueue, uint32_t submit_count, const VkSubmitInfo *submits, VkFence)
+{
+    uint64_t nb_command_buffers = 0;
+    for (uint32_t submit_idx = 0; submit_idx < submit_count; submit_idx++) {
+        nb_command_buffers += submits[submit_idx].commandBufferCount;
+    }
+    spin_for(call_overhead + command_buffer_cost * nb_command_buffers);
+    driver_command_buffers.fetch_add(
+        nb_command_buffers, std::memory_order_relaxed);
+    return VK_SUCCESS;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL stub_create_semaphore(
+    VkDevice,
+    const VkSemaphoreCreateInfo *,
+    const VkAllocationCallbacks *,
+    VkSemaphore *semaphore)
+{
+    *semaphore = reinterpret_cast<VkSemaphore>(uintptr_t{1});
+    return VK_SUCCESS;
+}
+
+VkCommandBuffer fake_command_buffer(size_t idx)
+{
+    return reinterpret_cast<VkCommandBuffer>(idx + 1);
+}
+
+struct LockedStrategy
+{
+    static constexpr std::string_view name = "mutex + vkQueueSubmit";
+
+    void submit(size_t idx)
+    {
+        VkCommandBuffer command_buffer = fake_command_buffer(idx);
+        VkSubmitInfo info{};
+        info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        info.commandBufferCount = 1;
+        info.pCommandBuffers = &command_buffer;
+
+        std::lock_guard guard(lock);
+        vkQueueSubmit(VK_NULL_HANDLE, 1, &info, VK_NULL_HANDLE);
+    }
+
+    void finish()
+    {
+    }
+
+    std::mutex lock;
+};
+
+struct RingStrategy
+{
+    static constexpr std::string_view name = "pvk::SubmitRing";
+
+    void submit(size_t idx)
+    {
+        pvk::Submission submission;
+        submission.command_buffer = fake_command_buffer(idx);
+        last_ticket = ring.push(submission);
+    }
+
+    void finish()
+    {
+        ring.wait_submitted(last_ticket);
+    }
+
+    pvk::SubmitRing ring{
+        VK_NULL_HANDLE,
+        pvk::Timeline::create(
+            VK_NULL_HANDLE, true, nullptr, nullptr, "bench"),
+        "bench"};
+    // Tickets grow, the last pushed one covers every thread's work
+    static thread_local inline uint64_t last_ticket = 0;
+};
+
+template <typename Strategy>
+void run()
+{
+    for (size_t nb_threads : thread_counts) {
+        auto strategy = std::make_unique<Strategy>();
+        driver_command_buffers.store(0);
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> threads;
+        for (size_t thread_idx = 0; thread_idx < nb_threads; thread_idx++) {
+            threads.emplace_back([&strategy]() {
+                for (size_t idx = 0; idx < submits_per_thread; idx++) {
+                    strategy->submit(idx);
+                }
+                strategy->finish();
+            });
+        }
+        std::ranges::for_each(threads, [](auto &t) { t.join(); });
+        auto stop = std::chrono::steady_clock::now();
+
+        double seconds = std::chrono::duration<double>(stop - start).count();
+        double msubmits = nb_threads * submits_per_thread / seconds / 1e6;
+        std::cout << std::format(
+            "{:<24} {:>3} threads: {:>6.2f} Msubmits/s ({} reached driver)\n",
+            Strategy::name,
+            nb_threads,
+            msubmits,
+            driver_command_buffers.load());
+    }
+}
+
+} // namespace
+
+int main()
+{
+    vkQueueSubmit = stub_queue_submit;
+    vkCreateSemaphore = stub_create_semaphore;
+    run<LockedStrategy>();
+    run<RingStrategy>();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,402 @@
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+#include <pvk/log.hh>
+#include <pvk/logger.hh>
+
+#include "pvk/internal/bindless_table.hh"
+#include "pvk/internal/physical_device_info.hh"
+#include "pvk/internal/result.hh"
+#include "pvk/internal/timeline.hh"
+#include "pvk/internal/vk_api.hh"
+
+namespace {
+
+using Kind = pvk::BindlessTable::Kind;
+
+constexpr std::array<VkDescriptorType, pvk::BindlessTable::nb_kinds>
+    descriptor_types{
+        VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+        VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
+        VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+        VK_DESCRIPTOR_TYPE_SAMPLER,
+    };
+
+constexpr std::array<const char *, pvk::BindlessTable::nb_kinds> kind_names{
+    "storage buffer",
+    "sampled image",
+    "storage image",
+    "sampler",
+};
+
+// Arrays sizes asked for, lowered to the device limits
+constexpr std::array<uint32_t, pvk::BindlessTable::nb_kinds>
+    preferred_capacities{65536, 65536, 16384, 2048};
+constexpr uint32_t max_push_constant_size = 128;
+
+size_t kind_idx(Kind kind)
+{
+    return static_cast<size_t>(kind);
+}
+
+std::array<uint32_t, pvk::BindlessTable::nb_kinds>
+    capacities_of(const pvk::PhysicalDeviceInfo &info)
+{
+    const VkPhysicalDeviceVulkan12Properties &limits = info.properties_12;
+    std::array<uint32_t, pvk::BindlessTable::nb_kinds> capacities{
+        std::min({
+            preferred_capacities[kind_idx(Kind::STORAGE_BUFFER)],
+            limits.maxPerStageDescriptorUpdateAfterBindStorageBuffers,
+            limits.maxDescriptorSetUpdateAfterBindStorageBuffers,
+        }),
+        std::min({
+            preferred_capacities[kind_idx(Kind::SAMPLED_IMAGE)],
+            limits.maxPerStageDescriptorUpdateAfterBindSampledImages,
+            limits.maxDescriptorSetUpdateAfterBindSampledImages,
+        }),
+        std::min({
+            preferred_capacities[kind_idx(Kind::STORAGE_IMAGE)],
+            limits.maxPerStageDescriptorUpdateAfterBindStorageImages,
+            limits.maxDescriptorSetUpdateAfterBindStorageImages,
+        }),
+        std::min({
+            preferred_capacities[kind_idx(Kind::SAMPLER)],
+            limits.maxPerStageDescriptorUpdateAfterBindSamplers,
+            limits.maxDescriptorSetUpdateAfterBindSamplers,
+        }),
+    };
+
+    // Samplers are not resources, the other arrays share the stage limit
+    uint64_t resources = uint64_t{capacities[0]} + capacities[1] +
+                         capacities[2];
+    uint64_t max_resources = limits.maxPerStageUpdateAfterBindResources;
+    if (resources > max_resources) {
+        for (size_t idx = 0; idx < 3; idx++) {
+            capacities[idx] = static_cast<uint32_t>(
+                capacities[idx] * max_resources / resources);
+        }
+    }
+    return capacities;
+}
+
+} // namespace
+
+namespace pvk {
+
+bool BindlessTable::supported(const PhysicalDeviceInfo &info)
+{
+    const VkPhysicalDeviceVulkan12Features &features = info.features_12;
+    return info.api_version >= VK_API_VERSION_1_2 &&
+           features.runtimeDescriptorArray == VK_TRUE &&
+           features.descriptorBindingPartiallyBound == VK_TRUE &&
+           features.descriptorBindingUpdateUnusedWhilePending == VK_TRUE &&
+           features.descriptorBindingStorageBufferUpdateAfterBind ==
+               VK_TRUE &&
+           features.descriptorBindingSampledImageUpdateAfterBind == VK_TRUE &&
+           features.descriptorBindingStorageImageUpdateAfterBind == VK_TRUE;
+}
+
+void BindlessTable::enable(VkPhysicalDeviceVulkan12Features &features)
+{
+    features.runtimeDescriptorArray = VK_TRUE;
+    features.descriptorBindingPartiallyBound = VK_TRUE;
+    features.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+    features.descriptorBindingStorageBufferUpdateAfterBind = VK_TRUE;
+    features.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+    features.descriptorBindingStorageImageUpdateAfterBind = VK_TRUE;
+}
+
+BindlessTable::BindlessTable(
+    VkDevice device, const VkAllocationCallbacks *callbacks)
+    : m_device(device), m_callbacks(callbacks)
+{
+    l.set_name("BindlessTable");
+}
+
+BindlessTable::~BindlessTable()
+{
+    vkDestroyPipelineLayout(m_device, m_pipeline_layout, m_callbacks);
+    // Frees the set along
+    vkDestroyDescriptorPool(m_device, m_pool, m_callbacks);
+    vkDestroyDescriptorSetLayout(m_device, m_set_layout, m_callbacks);
+}
+
+std::unique_ptr<BindlessTable> BindlessTable::create(
+    VkDevice device,
+    const PhysicalDeviceInfo &info,
+    const VkAllocationCallbacks *callbacks) noexcept
+try {
+    std::unique_ptr<BindlessTable> table(
+        new BindlessTable(device, callbacks));
+    Logger &l = table->l;
+
+    std::array<uint32_t, nb_kinds> capacities = capacities_of(info);
+    std::array<VkDescriptorSetLayoutBinding, nb_kinds> bindings{};
+    std::array<VkDescriptorBindingFlags, nb_kinds> binding_flags{};
+    binding_flags.fill(
+        VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT |
+        VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT |
+        VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT);
+    std::vector<VkDescriptorPoolSize> pool_sizes;
+    for (uint32_t idx = 0; idx < nb_kinds; idx++) {
+        table->m_slots[idx].capacity = capacities[idx];
+        table->m_slots[idx].live.resize(capacities[idx]);
+        bindings[idx].binding = idx;
+        bindings[idx].descriptorType = descriptor_types[idx];
+        bindings[idx].descriptorCount = capacities[idx];
+        bindings[idx].stageFlags = VK_SHADER_STAGE_ALL;
+        if (capacities[idx] != 0) {
+            pool_sizes.emplace_back(
+                VkDescriptorPoolSize{descriptor_types[idx], capacities[idx]});
+        }
+    }
+
+    VkDescriptorSetLayoutBindingFlagsCreateInfo flags_info{};
+    flags_info.sType =
+        VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+    flags_info.bindingCount = nb_kinds;
+    flags_info.pBindingFlags = binding_flags.data();
+
+    VkDescriptorSetLayoutCreateInfo layout_info{};
+    layout_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layout_info.pNext = &flags_info;
+    layout_info.flags =
+        VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+    layout_info.bindingCount = nb_kinds;
+    layout_info.pBindings = bindings.data();
+    VkResult status = vkCreateDescriptorSetLayout(
+        device, &layout_info, callbacks, &table->m_set_layout);
+    if (status != VK_SUCCESS) {
+        l.warning("Bindless layout creation failue: {}", vk_to_str(status));
+        return nullptr;
+    }
+
+    VkDescriptorPoolCreateInfo pool_info{};
+    pool_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    pool_info.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+    pool_info.maxSets = 1;
+    pool_info.poolSizeCount = static_cast<uint32_t>(pool_sizes.size());
+    pool_info.pPoolSizes = pool_sizes.data();
+    status =
+        vkCreateDescriptorPool(device, &pool_info, callbacks, &table->m_pool);
+    if (status != VK_SUCCESS) {
+        l.warning("Bindless pool creation failue: {}", vk_to_str(status));
+        return nullptr;
+    }
+
+    VkDescriptorSetAllocateInfo allocate_info{};
+    allocate_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocate_info.descriptorPool = table->m_pool;
+    allocate_info.descriptorSetCount = 1;
+    allocate_info.pSetLayouts = &table->m_set_layout;
+    status = vkAllocateDescriptorSets(device, &allocate_info, &table->m_set);
+    if (status != VK_SUCCESS) {
+        l.warning("Bindless set allocation failue: {}", vk_to_str(status));
+        return nullptr;
+    }
+
+    table->m_push_constant_size = std::min(
+        max_push_constant_size, info.limits().maxPushConstantsSize);
+    VkPushConstantRange push_range{};
+    push_range.stageFlags = VK_SHADER_STAGE_ALL;
+    push_range.size = table->m_push_constant_size;
+
+    VkPipelineLayoutCreateInfo pipeline_layout_info{};
+    pipeline_layout_info.sType =
+        VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipeline_layout_info.setLayoutCount = 1;
+    pipeline_layout_info.pSetLayouts = &table->m_set_layout;
+    pipeline_layout_info.pushConstantRangeCount = 1;
+    pipeline_layout_info.pPushConstantRanges = &push_range;
+    status = vkCreatePipelineLayout(
+        device, &pipeline_layout_info, callbacks, &table->m_pipeline_layout);
+    if (status != VK_SUCCESS) {
+        l.warning(
+            "Bindless pipeline layout creation failue: {}",
+            vk_to_str(status));
+        return nullptr;
+    }
+
+    l.debug(
+        "{} storage buffers, {} sampled images, {} storage images, "
+        "{} samplers",
+        capacities[0],
+        capacities[1],
+        capacities[2],
+        capacities[3]);
+    return table;
+} catch (...) {
+    pvk::warning("Bindless table creation failue: Out of host memory");
+    return nullptr;
+}
+
+uint32_t BindlessTable::acquire(Kind kind) noexcept
+try {
+    Slots &slots = m_slots[kind_idx(kind)];
+    std::lock_guard lock(slots.lock);
+    if (slots.free.empty() && !slots.removed.empty()) {
+        auto done = std::stable_partition(
+            std::begin(slots.removed),
+            std::end(slots.removed),
+            [](const Removed &removed) {
+                return removed.timeline->completed() < removed.value;
+            });
+        for (auto removed = done; removed != std::end(slots.removed);
+             removed++) {
+            slots.free.emplace_back(removed->index);
+        }
+        slots.removed.erase(done, std::end(slots.removed));
+    }
+
+    uint32_t index = invalid_index;
+    if (!slots.free.empty()) {
+        index = slots.free.back();
+        slots.free.pop_back();
+    } else if (slots.next < slots.capacity) {
+        index = slots.next++;
+    } else {
+        l.warning(
+            "Bindless {} failue: All {} slots in use",
+            kind_names[kind_idx(kind)],
+            slots.capacity);
+        return invalid_index;
+    }
+    slots.live[index] = true;
+    slots.in_use++;
+    return index;
+} catch (...) {
+    l.warning("Bindless slot failue: Out of host memory");
+    return invalid_index;
+}
+
+uint32_t BindlessTable::write(
+    Kind kind,
+    const VkDescriptorBufferInfo *buffer_info,
+    const VkDescriptorImageInfo *image_info) noexcept
+{
+    uint32_t index = acquire(kind);
+    if (index == invalid_index) {
+        return invalid_index;
+    }
+
+    VkWriteDescriptorSet update{};
+    update.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    update.dstSet = m_set;
+    update.dstBinding = static_cast<uint32_t>(kind);
+    update.dstArrayElement = index;
+    update.descriptorCount = 1;
+    update.descriptorType = descriptor_types[kind_idx(kind)];
+    update.pBufferInfo = buffer_info;
+    update.pImageInfo = image_info;
+
+    std::lock_guard lock(m_update_lock);
+    vkUpdateDescriptorSets(m_device, 1, &update, 0, nullptr);
+    return index;
+}
+
+uint32_t BindlessTable::add_buffer(
+    VkBuffer buffer, VkDeviceSize offset, VkDeviceSize range) noexcept
+{
+    VkDescriptorBufferInfo buffer_info{buffer, offset, range};
+    return write(Kind::STORAGE_BUFFER, &buffer_info, nullptr);
+}
+
+uint32_t BindlessTable::add_sampled_image(
+    VkImageView view, VkImageLayout layout) noexcept
+{
+    VkDescriptorImageInfo image_info{VK_NULL_HANDLE, view, layout};
+    return write(Kind::SAMPLED_IMAGE, nullptr, &image_info);
+}
+
+uint32_t BindlessTable::add_storage_image(
+    VkImageView view, VkImageLayout layout) noexcept
+{
+    VkDescriptorImageInfo image_info{VK_NULL_HANDLE, view, layout};
+    return write(Kind::STORAGE_IMAGE, nullptr, &image_info);
+}
+
+uint32_t BindlessTable::add_sampler(VkSampler sampler) noexcept
+{
+    VkDescriptorImageInfo image_info{
+        sampler, VK_NULL_HANDLE, VK_IMAGE_LAYOUT_UNDEFINED};
+    return write(Kind::SAMPLER, nullptr, &image_info);
+}
+
+void BindlessTable::remove(
+    Kind kind,
+    uint32_t index,
+    std::shared_ptr<Timeline> timeline,
+    uint64_t value) noexcept
+try {
+    Slots &slots = m_slots[kind_idx(kind)];
+    std::lock_guard lock(slots.lock);
+    if (index >= slots.next || !slots.live[index]) {
+        l.warning(
+            "Bindless {} failue: Slot {} not in use",
+            kind_names[kind_idx(kind)],
+            index);
+        return;
+    }
+    if (timeline) {
+        slots.removed.emplace_back(Removed{index, std::move(timeline), value});
+    } else {
+        slots.free.emplace_back(index);
+    }
+    slots.live[index] = false;
+    slots.in_use--;
+} catch (...) {
+    // Leaked until the table goes
+    l.warning("Bindless slot failue: Out of host memory");
+}
+
+void BindlessTable::bind(
+    VkCommandBuffer buffer, VkPipelineBindPoint bind_point) noexcept
+{
+    vkCmdBindDescriptorSets(
+        buffer, bind_point, m_pipeline_layout, 0, 1, &m_set, 0, nullptr);
+}
+
+void BindlessTable::push(
+    VkCommandBuffer buffer,
+    std::span<const uint32_t> indices,
+    uint32_t offset) noexcept
+{
+    size_t first = offset * sizeof(uint32_t);
+    size_t size = indices.size_bytes();
+    if (first + size > m_push_constant_size) {
+        l.warning(
+            "Bindless push failue: {} bytes past the {} of push constants",
+            first + size - m_push_constant_size,
+            m_push_constant_size);
+        return;
+    }
+    vkCmdPushConstants(
+        buffer,
+        m_pipeline_layout,
+        VK_SHADER_STAGE_ALL,
+        static_cast<uint32_t>(first),
+        static_cast<uint32_t>(size),
+        indices.data());
+}
+
+uint32_t BindlessTable::capacity(Kind kind) const noexcept
+{
+    return m_slots[kind_idx(kind)].capacity;
+}
+
+uint32_t BindlessTable::in_use(Kind kind) const noexcept
+{
+    const Slots &slots = m_slots[kind_idx(kind)];
+    std::lock_guard lock(slots.lock);
+    return slots.in_use;
+}
+
+} // namespace pvk
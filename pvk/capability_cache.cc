@@ -0,0 +1,360 @@
+#include <algorithm>
+#include <array>
+#include <filesystem>
+#include <format>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#include <pvk/logger.hh>
+
+#include "pvk/internal/capability_cache.hh"
+#include "pvk/internal/layer_utils.hh"
+#include "pvk/internal/physical_device_info.hh"
+#include "pvk/internal/vk_api.hh"
+
+namespace {
+
+// Caches are a few tens of KiB, anything bigger is not ours
+constexpr uint64_t max_payload_size = 64 * 1024 * 1024;
+
+uint64_t fnv1a(const std::vector<std::byte> &bytes)
+{
+    uint64_t hash = 0xcbf29ce484222325;
+    for (std::byte b : bytes) {
+        hash ^= static_cast<uint64_t>(b);
+        hash *= 0x100000001b3;
+    }
+    return hash;
+}
+
+bool same_layer(const VkLayerProperties &lhs, const VkLayerProperties &rhs)
+{
+    return std::string_view(lhs.layerName) == rhs.layerName &&
+        lhs.specVersion == rhs.specVersion &&
+        lhs.implementationVersion == rhs.implementationVersion;
+}
+
+bool same_extension(
+    const VkExtensionProperties &lhs, const VkExtensionProperties &rhs)
+{
+    return std::string_view(lhs.extensionName) == rhs.extensionName &&
+        lhs.specVersion == rhs.specVersion;
+}
+
+struct Writer
+{
+    template <typename T>
+    void put(const T &value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        const auto *first = reinterpret_cast<const std::byte *>(&value);
+        bytes.insert(std::end(bytes), first, first + sizeof(T));
+    }
+
+    template <typename T>
+    void put_array(const std::vector<T> &values)
+    {
+        put(static_cast<uint32_t>(values.size()));
+        for (const T &value : values) {
+            put(value);
+        }
+    }
+
+    void put_string(const std::string &value)
+    {
+        put(static_cast<uint32_t>(value.size()));
+        const auto *first = reinterpret_cast<const std::byte *>(value.data());
+        bytes.insert(std::end(bytes), first, first + value.size());
+    }
+
+    void put_layers(const std::vector<pvk::LayerExtensions> &layers)
+    {
+        put(static_cast<uint32_t>(layers.size()));
+        for (const auto &layer : layers) {
+            put_string(layer.layer);
+            put(static_cast<uint32_t>(layer.extensions.size()));
+            for (const auto &extension : layer.extensions) {
+                put_string(extension);
+            }
+        }
+    }
+
+    std::vector<std::byte> bytes;
+};
+
+struct Reader
+{
+    template <typename T>
+    bool get(T &value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        if (bytes.size() - offset < sizeof(T)) {
+            return false;
+        }
+        std::memcpy(&value, bytes.data() + offset, sizeof(T));
+        offset += sizeof(T);
+        return true;
+    }
+
+    template <typename T>
+    bool get_array(std::vector<T> &values)
+    {
+        uint32_t count = 0;
+        if (!get(count) || (bytes.size() - offset) / sizeof(T) < count) {
+            return false;
+        }
+        values.resize(count);
+        for (T &value : values) {
+            get(value);
+        }
+        return true;
+    }
+
+    bool get_string(std::string &value)
+    {
+        uint32_t size = 0;
+        if (!get(size) || bytes.size() - offset < size) {
+            return false;
+        }
+        value.assign(
+            reinterpret_cast<const char *>(bytes.data() + offset), size);
+        offset += size;
+        return true;
+    }
+
+    bool get_layers(std::vector<pvk::LayerExtensions> &layers)
+    {
+        uint32_t nb_layers = 0;
+        if (!get(nb_layers)) {
+            return false;
+        }
+        layers.clear();
+        for (uint32_t layer_idx = 0; layer_idx < nb_layers; layer_idx++) {
+            pvk::LayerExtensions &layer = layers.emplace_back();
+            uint32_t nb_extensions = 0;
+            if (!get_string(layer.layer) || !get(nb_extensions)) {
+                return false;
+            }
+            for (uint32_t ext_idx = 0; ext_idx < nb_extensions; ext_idx++) {
+                if (!get_string(layer.extensions.emplace_back())) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    const std::vector<std::byte> &bytes;
+    size_t offset = 0;
+};
+
+} // namespace
+
+namespace pvk {
+
+uint32_t loader_version()
+{
+    uint32_t output = VK_API_VERSION_1_0;
+    if (vkEnumerateInstanceVersion == nullptr ||
+        vkEnumerateInstanceVersion(&output) != VK_SUCCESS) {
+        return VK_API_VERSION_1_0;
+    }
+    return output;
+}
+
+CapabilityCache::DeviceKey
+    CapabilityCache::DeviceKey::of(const VkPhysicalDeviceProperties &properties)
+{
+    DeviceKey output{};
+    output.vendor_id = properties.vendorID;
+    output.device_id = properties.deviceID;
+    output.driver_version = properties.driverVersion;
+    output.api_version = properties.apiVersion;
+    std::ranges::copy(
+        properties.pipelineCacheUUID, std::begin(output.pipeline_cache_uuid));
+    return output;
+}
+
+CapabilityCache CapabilityCache::load(const std::string &path, Logger &l)
+{
+    CapabilityCache output;
+    output.m_path = path;
+
+    std::FILE *file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        l.debug("Capability cache \"{}\" does not exist yet", path);
+        return output;
+    }
+
+    FileHeader header{};
+    std::vector<std::byte> payload;
+    bool read_status = std::fread(&header, sizeof(header), 1, file) == 1 &&
+        header.magic == magic && header.version == version &&
+        header.payload_size <= max_payload_size;
+    if (read_status) {
+        payload.resize(header.payload_size);
+        read_status =
+            std::fread(payload.data(), 1, payload.size(), file) ==
+                payload.size() &&
+            fnv1a(payload) == header.payload_checksum;
+    }
+    std::fclose(file);
+
+    if (!read_status || !output.parse(payload, header.device_count)) {
+        l.notice("Capability cache \"{}\" is unusable: Rebuild it", path);
+        output = CapabilityCache();
+        output.m_path = path;
+        return output;
+    }
+
+    l.debug(
+        "Capability cache \"{}\" loaded with {} devices",
+        path,
+        output.m_devices.size());
+    return output;
+}
+
+bool CapabilityCache::parse(
+    const std::vector<std::byte> &payload, uint32_t device_count)
+{
+    Reader r{payload};
+    if (!r.get(m_instance.loader_version) ||
+        !r.get_array(m_instance.layers) ||
+        !r.get_array(m_instance.extensions) ||
+        !r.get_layers(m_instance_layers)) {
+        return false;
+    }
+
+    for (uint32_t device_idx = 0; device_idx < device_count; device_idx++) {
+        DeviceEntry &entry = m_devices.emplace_back();
+        if (!r.get(entry.key) || !r.get_array(entry.extensions) ||
+            !r.get_array(entry.formats) || !r.get_layers(entry.layers)) {
+            return false;
+        }
+    }
+    return r.offset == payload.size();
+}
+
+std::vector<std::byte> CapabilityCache::serialize() const
+{
+    Writer w;
+    w.put(m_instance.loader_version);
+    w.put_array(m_instance.layers);
+    w.put_array(m_instance.extensions);
+    w.put_layers(m_instance_layers);
+
+    for (const auto &entry : m_devices) {
+        w.put(entry.key);
+        w.put_array(entry.extensions);
+        w.put_array(entry.formats);
+        w.put_layers(entry.layers);
+    }
+    return std::move(w.bytes);
+}
+
+bool CapabilityCache::store(Logger &l) const
+{
+    std::vector<std::byte> payload = serialize();
+
+    FileHeader header{};
+    header.magic = magic;
+    header.version = version;
+    header.device_count = static_cast<uint32_t>(m_devices.size());
+    header.payload_size = payload.size();
+    header.payload_checksum = fnv1a(payload);
+
+    std::string tmp_path =
+        std::format("{}.{:08x}.tmp", m_path, std::random_device()());
+    std::FILE *file = std::fopen(tmp_path.c_str(), "wb");
+    if (file == nullptr) {
+        l.warning("Capability cache \"{}\" creation failue", tmp_path);
+        return false;
+    }
+
+    bool write_status = std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+        std::fwrite(payload.data(), 1, payload.size(), file) == payload.size();
+    write_status = std::fclose(file) == 0 && write_status;
+
+    std::error_code ec;
+    if (write_status) {
+        std::filesystem::rename(tmp_path, m_path, ec);
+    }
+    if (!write_status || ec) {
+        l.warning("Capability cache \"{}\" write failue", m_path);
+        std::filesystem::remove(tmp_path, ec);
+        return false;
+    }
+
+    l.debug("Capability cache \"{}\" updated", m_path);
+    return true;
+}
+
+std::optional<std::vector<LayerExtensions>>
+    CapabilityCache::find_instance(const InstanceKey &key) const
+{
+    if (m_instance.loader_version == 0 ||
+        m_instance.loader_version != key.loader_version ||
+        !std::ranges::equal(m_instance.layers, key.layers, same_layer) ||
+        !std::ranges::equal(
+            m_instance.extensions, key.extensions, same_extension)) {
+        return std::nullopt;
+    }
+    return m_instance_layers;
+}
+
+void CapabilityCache::put_instance(
+    InstanceKey key, std::vector<LayerExtensions> layers)
+{
+    m_instance = std::move(key);
+    m_instance_layers = std::move(layers);
+    m_devices.clear();
+    m_dirty = true;
+}
+
+bool CapabilityCache::restore(PhysicalDeviceInfo &info) const
+{
+    DeviceKey key = DeviceKey::of(info.properties);
+    auto entry = std::ranges::find(m_devices, key, &DeviceEntry::key);
+    if (entry == std::end(m_devices)) {
+        return false;
+    }
+
+    info.extensions = entry->extensions;
+    info.formats = entry->formats;
+    info.layers = entry->layers;
+    return true;
+}
+
+void CapabilityCache::remember(const PhysicalDeviceInfo &info)
+{
+    DeviceEntry entry{
+        DeviceKey::of(info.properties),
+        info.extensions,
+        info.formats,
+        info.layers};
+
+    // Same device under an older driver or API version: stale
+    auto cached = std::ranges::find_if(m_devices, [&](const auto &device) {
+        return device.key.vendor_id == entry.key.vendor_id &&
+            device.key.device_id == entry.key.device_id;
+    });
+    if (cached == std::end(m_devices)) {
+        m_devices.emplace_back(std::move(entry));
+    } else {
+        *cached = std::move(entry);
+    }
+    m_dirty = true;
+}
+
+} // namespace pvk
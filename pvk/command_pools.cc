@@ -0,0 +1,350 @@
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <span>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+#include <pvk/logger.hh>
+
+#include "pvk/internal/command_pools.hh"
+#include "pvk/internal/result.hh"
+#include "pvk/internal/timeline.hh"
+#include "pvk/internal/vk_api.hh"
+
+namespace {
+
+// Command buffers are allocated by this many at once
+constexpr uint32_t buffer_chunk = 8;
+
+std::atomic<uint64_t> next_id{1};
+
+// Pools of the last CommandPools the thread recorded with
+struct ThreadCache
+{
+    uint64_t owner_id = 0;
+    void *pools = nullptr;
+};
+thread_local ThreadCache thread_cache;
+
+// Lives as long as the thread, the pools of a thread watch it
+thread_local std::shared_ptr<const bool> thread_token;
+
+} // namespace
+
+namespace pvk {
+
+CommandPools::CommandPools(
+    VkDevice device,
+    size_t nb_families,
+    const VkAllocationCallbacks *callbacks)
+    : m_device(device), m_nb_families(nb_families), m_callbacks(callbacks),
+      m_id(next_id.fetch_add(1, std::memory_order_relaxed))
+{
+    l.set_name("CommandPools");
+}
+
+CommandPools::~CommandPools()
+{
+    for (auto &[thread_id, pools] : m_threads) {
+        for (auto &pool : pools->recording) {
+            if (pool) {
+                destroy_pool(*pool);
+            }
+        }
+        for (auto &family_pools : pools->in_flight) {
+            std::ranges::for_each(
+                family_pools, [this](auto &pool) { destroy_pool(*pool); });
+        }
+        for (auto &family_pools : pools->free) {
+            std::ranges::for_each(
+                family_pools, [this](auto &pool) { destroy_pool(*pool); });
+        }
+    }
+}
+
+CommandPools::ThreadPools &CommandPools::thread_pools()
+{
+    if (thread_cache.owner_id == m_id) {
+        return *static_cast<ThreadPools *>(thread_cache.pools);
+    }
+
+    if (!thread_token) {
+        thread_token = std::make_shared<const bool>(true);
+    }
+
+    std::thread::id thread_id = std::this_thread::get_id();
+    ThreadPools *pools = nullptr;
+    {
+        std::shared_lock lock(m_threads_lock);
+        auto found = m_threads.find(thread_id);
+        if (found != std::end(m_threads)) {
+            pools = found->second.get();
+            // Left by an exited thread with the same id, adopted
+            std::lock_guard pools_lock(pools->lock);
+            pools->owner = thread_token;
+        }
+    }
+
+    if (pools == nullptr) {
+        auto new_pools = std::make_unique<ThreadPools>();
+        new_pools->owner = thread_token;
+        new_pools->recording.resize(m_nb_families);
+        new_pools->in_flight.resize(m_nb_families);
+        new_pools->free.resize(m_nb_families);
+
+        std::unique_lock lock(m_threads_lock);
+        pools = m_threads.try_emplace(thread_id, std::move(new_pools))
+                    .first->second.get();
+    }
+
+    thread_cache = ThreadCache{m_id, pools};
+    return *pools;
+}
+
+std::unique_ptr<CommandPools::Pool>
+    CommandPools::create_pool(uint32_t family_idx)
+{
+    VkCommandPoolCreateInfo create_info{};
+    create_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    create_info.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+    create_info.queueFamilyIndex = family_idx;
+
+    auto pool = std::make_unique<Pool>();
+    VkResult status =
+        vkCreateCommandPool(m_device, &create_info, m_callbacks, &pool->pool);
+    if (status != VK_SUCCESS) {
+        l.warning("Command pool creation failue: {}", vk_to_str(status));
+        return nullptr;
+    }
+    m_nb_pools.fetch_add(1, std::memory_order_relaxed);
+    return pool;
+}
+
+void CommandPools::destroy_pool(Pool &pool) noexcept
+{
+    // Frees the buffers of the pool along
+    vkDestroyCommandPool(m_device, pool.pool, m_callbacks);
+    pool.pool = VK_NULL_HANDLE;
+}
+
+CommandPools::Pool *
+    CommandPools::recording_pool(ThreadPools &pools, uint32_t family_idx)
+{
+    if (family_idx >= m_nb_families) {
+        l.warning("No queue family {}: No command pool", family_idx);
+        return nullptr;
+    }
+
+    std::lock_guard lock(pools.lock);
+    auto &recording = pools.recording[family_idx];
+    if (recording) {
+        return recording.get();
+    }
+
+    // Once per frame: take back the pools whose submissions completed
+    auto &in_flight = pools.in_flight[family_idx];
+    auto &free = pools.free[family_idx];
+    auto done = std::stable_partition(
+        std::begin(in_flight), std::end(in_flight), [](const auto &pool) {
+            return pool->timeline->completed() < pool->value;
+        });
+    for (auto pool = done; pool != std::end(in_flight); pool++) {
+        VkResult status = vkResetCommandPool(m_device, (*pool)->pool, 0);
+        if (status != VK_SUCCESS) {
+            l.warning("Command pool reset failue: {}", vk_to_str(status));
+            destroy_pool(**pool);
+            m_nb_pools.fetch_sub(1, std::memory_order_relaxed);
+            continue;
+        }
+        (*pool)->used_primaries = 0;
+        (*pool)->used_secondaries = 0;
+        (*pool)->timeline.reset();
+        free.emplace_back(std::move(*pool));
+    }
+    in_flight.erase(done, std::end(in_flight));
+
+    if (!free.empty()) {
+        recording = std::move(free.back());
+        free.pop_back();
+    } else {
+        recording = create_pool(family_idx);
+    }
+    return recording.get();
+}
+
+VkCommandBuffer
+    CommandPools::next_buffer(Pool &pool, VkCommandBufferLevel level) noexcept
+try {
+    bool primary = level == VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    auto &buffers = primary ? pool.primaries : pool.secondaries;
+    size_t &used = primary ? pool.used_primaries : pool.used_secondaries;
+
+    if (used == buffers.size()) {
+        VkCommandBufferAllocateInfo allocate_info{};
+        allocate_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocate_info.commandPool = pool.pool;
+        allocate_info.level = level;
+        allocate_info.commandBufferCount = buffer_chunk;
+
+        buffers.resize(used + buffer_chunk);
+        VkResult status = vkAllocateCommandBuffers(
+            m_device, &allocate_info, buffers.data() + used);
+        if (status != VK_SUCCESS) {
+            buffers.resize(used);
+            l.warning(
+                "Command buffers allocation failue: {}", vk_to_str(status));
+            return VK_NULL_HANDLE;
+        }
+    }
+    return buffers[used++];
+} catch (...) {
+    l.warning("Command buffers allocation failue: Out of host memory");
+    return VK_NULL_HANDLE;
+}
+
+VkCommandBuffer CommandPools::primary(uint32_t family_idx) noexcept
+try {
+    Pool *pool = recording_pool(thread_pools(), family_idx);
+    if (pool == nullptr) {
+        return VK_NULL_HANDLE;
+    }
+    VkCommandBuffer buffer =
+        next_buffer(*pool, VK_COMMAND_BUFFER_LEVEL_PRIMARY);
+    if (buffer == VK_NULL_HANDLE) {
+        return VK_NULL_HANDLE;
+    }
+
+    VkCommandBufferBeginInfo begin_info{};
+    begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    VkResult status = vkBeginCommandBuffer(buffer, &begin_info);
+    if (status != VK_SUCCESS) {
+        l.warning("Command buffer begin failue: {}", vk_to_str(status));
+        return VK_NULL_HANDLE;
+    }
+    return buffer;
+} catch (...) {
+    l.warning("Command pool failue: Out of host memory");
+    return VK_NULL_HANDLE;
+}
+
+VkCommandBuffer CommandPools::secondary(
+    uint32_t family_idx,
+    const VkCommandBufferInheritanceInfo &inheritance,
+    VkCommandBufferUsageFlags usage) noexcept
+try {
+    Pool *pool = recording_pool(thread_pools(), family_idx);
+    if (pool == nullptr) {
+        return VK_NULL_HANDLE;
+    }
+    VkCommandBuffer buffer =
+        next_buffer(*pool, VK_COMMAND_BUFFER_LEVEL_SECONDARY);
+    if (buffer == VK_NULL_HANDLE) {
+        return VK_NULL_HANDLE;
+    }
+
+    VkCommandBufferBeginInfo begin_info{};
+    begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | usage;
+    begin_info.pInheritanceInfo = &inheritance;
+    VkResult status = vkBeginCommandBuffer(buffer, &begin_info);
+    if (status != VK_SUCCESS) {
+        l.warning("Command buffer begin failue: {}", vk_to_str(status));
+        return VK_NULL_HANDLE;
+    }
+    return buffer;
+} catch (...) {
+    l.warning("Command pool failue: Out of host memory");
+    return VK_NULL_HANDLE;
+}
+
+void CommandPools::stitch(
+    VkCommandBuffer primary,
+    std::span<const VkCommandBuffer> secondaries) noexcept
+{
+    if (secondaries.empty()) {
+        return;
+    }
+    vkCmdExecuteCommands(
+        primary,
+        static_cast<uint32_t>(secondaries.size()),
+        secondaries.data());
+}
+
+void CommandPools::retire(
+    uint32_t family_idx,
+    std::shared_ptr<Timeline> timeline,
+    uint64_t value) noexcept
+try {
+    if (family_idx >= m_nb_families) {
+        return;
+    }
+
+    std::shared_lock threads_lock(m_threads_lock);
+    for (auto &[thread_id, pools] : m_threads) {
+        std::lock_guard lock(pools->lock);
+        auto &recording = pools->recording[family_idx];
+        if (!recording) {
+            continue;
+        }
+        recording->timeline = timeline;
+        recording->value = value;
+        pools->in_flight[family_idx].emplace_back(std::move(recording));
+    }
+    threads_lock.unlock();
+    reclaim_exited();
+} catch (...) {
+    // Kept recording: the pool only joins the next frame
+    l.warning("Command pool retire failue: Out of host memory");
+}
+
+void CommandPools::reclaim_exited() noexcept
+{
+    std::unique_lock threads_lock(m_threads_lock);
+    std::erase_if(m_threads, [this](auto &entry) {
+        ThreadPools &pools = *entry.second;
+        std::lock_guard lock(pools.lock);
+        if (!pools.owner.expired()) {
+            return false;
+        }
+
+        bool empty = true;
+        for (size_t family_idx = 0; family_idx < m_nb_families;
+             family_idx++) {
+            auto &in_flight = pools.in_flight[family_idx];
+            // Order no longer matters, std::partition does not allocate
+            auto done = std::partition(
+                std::begin(in_flight),
+                std::end(in_flight),
+                [](const auto &pool) {
+                    return pool->timeline->completed() < pool->value;
+                });
+            auto &free = pools.free[family_idx];
+            for (auto pool = done; pool != std::end(in_flight); pool++) {
+                destroy_pool(**pool);
+            }
+            for (auto &pool : free) {
+                destroy_pool(*pool);
+            }
+            m_nb_pools.fetch_sub(
+                static_cast<size_t>(std::end(in_flight) - done) + free.size(),
+                std::memory_order_relaxed);
+            in_flight.erase(done, std::end(in_flight));
+            free.clear();
+            // A recording pool waits for the retire of its family
+            empty = empty && in_flight.empty() &&
+                !pools.recording[family_idx];
+        }
+        return empty;
+    });
+}
+
+} // namespace pvk
@@ -0,0 +1,559 @@
+#include <algorithm>
+#include <bit>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+#include <pvk/descriptor_cache_stats.hh>
+#include <pvk/logger.hh>
+
+#include "pvk/internal/descriptor_cache.hh"
+#include "pvk/internal/result.hh"
+#include "pvk/internal/timeline.hh"
+#include "pvk/internal/vk_api.hh"
+
+namespace {
+
+// Sets in the first pool of a layout, doubling with every new pool
+constexpr uint32_t first_pool_sets = 16;
+constexpr uint32_t max_pool_sets = 1024;
+
+// Multiply and xorshift per value, one step per word: descriptor writes
+// are hashed on every lookup
+struct Hasher
+{
+    template <typename T> void add(T value)
+    {
+        uint64_t bits = 0;
+        if constexpr (std::is_pointer_v<T>) {
+            bits = reinterpret_cast<uintptr_t>(value);
+        } else if constexpr (std::is_floating_point_v<T>) {
+            bits = std::bit_cast<uint32_t>(static_cast<float>(value));
+        } else {
+            bits = static_cast<uint64_t>(value);
+        }
+        hash = (hash ^ bits) * 0x9e3779b97f4a7c15;
+        hash ^= hash >> 29;
+    }
+
+    uint64_t hash = 0xcbf29ce484222325;
+};
+
+void hash_write(Hasher &hasher, const pvk::DescriptorWrite &write)
+{
+    hasher.add(write.binding);
+    hasher.add(write.array_element);
+    hasher.add(write.type);
+    hasher.add(write.buffer.buffer);
+    hasher.add(write.buffer.offset);
+    hasher.add(write.buffer.range);
+    hasher.add(write.image.sampler);
+    hasher.add(write.image.imageView);
+    hasher.add(write.image.imageLayout);
+    hasher.add(write.texel_view);
+}
+
+bool same_write(
+    const pvk::DescriptorWrite &lhs, const pvk::DescriptorWrite &rhs)
+{
+    return lhs.binding == rhs.binding &&
+           lhs.array_element == rhs.array_element && lhs.type == rhs.type &&
+           lhs.buffer.buffer == rhs.buffer.buffer &&
+           lhs.buffer.offset == rhs.buffer.offset &&
+           lhs.buffer.range == rhs.buffer.range &&
+           lhs.image.sampler == rhs.image.sampler &&
+           lhs.image.imageView == rhs.image.imageView &&
+           lhs.image.imageLayout == rhs.image.imageLayout &&
+           lhs.texel_view == rhs.texel_view;
+}
+
+bool uses_image_info(VkDescriptorType type)
+{
+    switch (type) {
+    case VK_DESCRIPTOR_TYPE_SAMPLER:
+    case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+    case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
+    case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+    case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool uses_texel_view(VkDescriptorType type)
+{
+    return type == VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER ||
+           type == VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER;
+}
+
+} // namespace
+
+namespace pvk {
+
+size_t DescriptorCache::LayoutKeyHash::operator()(
+    const LayoutKey &key) const noexcept
+{
+    Hasher hasher;
+    hasher.add(key.flags);
+    for (const Binding &binding : key.bindings) {
+        hasher.add(binding.binding);
+        hasher.add(binding.type);
+        hasher.add(binding.count);
+        hasher.add(binding.stages);
+        for (VkSampler sampler : binding.immutable_samplers) {
+            hasher.add(sampler);
+        }
+    }
+    return static_cast<size_t>(hasher.hash);
+}
+
+size_t DescriptorCache::SamplerHash::operator()(
+    const VkSamplerCreateInfo &info) const noexcept
+{
+    Hasher hasher;
+    hasher.add(info.flags);
+    hasher.add(info.magFilter);
+    hasher.add(info.minFilter);
+    hasher.add(info.mipmapMode);
+    hasher.add(info.addressModeU);
+    hasher.add(info.addressModeV);
+    hasher.add(info.addressModeW);
+    hasher.add(info.mipLodBias);
+    hasher.add(info.anisotropyEnable);
+    hasher.add(info.maxAnisotropy);
+    hasher.add(info.compareEnable);
+    hasher.add(info.compareOp);
+    hasher.add(info.minLod);
+    hasher.add(info.maxLod);
+    hasher.add(info.borderColor);
+    hasher.add(info.unnormalizedCoordinates);
+    return static_cast<size_t>(hasher.hash);
+}
+
+bool DescriptorCache::SamplerEqual::operator()(
+    const VkSamplerCreateInfo &lhs,
+    const VkSamplerCreateInfo &rhs) const noexcept
+{
+    return lhs.flags == rhs.flags && lhs.magFilter == rhs.magFilter &&
+           lhs.minFilter == rhs.minFilter &&
+           lhs.mipmapMode == rhs.mipmapMode &&
+           lhs.addressModeU == rhs.addressModeU &&
+           lhs.addressModeV == rhs.addressModeV &&
+           lhs.addressModeW == rhs.addressModeW &&
+           lhs.mipLodBias == rhs.mipLodBias &&
+           lhs.anisotropyEnable == rhs.anisotropyEnable &&
+           lhs.maxAnisotropy == rhs.maxAnisotropy &&
+           lhs.compareEnable == rhs.compareEnable &&
+           lhs.compareOp == rhs.compareOp && lhs.minLod == rhs.minLod &&
+           lhs.maxLod == rhs.maxLod && lhs.borderColor == rhs.borderColor &&
+           lhs.unnormalizedCoordinates == rhs.unnormalizedCoordinates;
+}
+
+DescriptorCache::DescriptorCache(
+    VkDevice device, const VkAllocationCallbacks *callbacks)
+    : m_device(device), m_callbacks(callbacks)
+{
+    l.set_name("DescriptorCache");
+}
+
+DescriptorCache::~DescriptorCache()
+{
+    for (auto &[layout, pools] : m_layout_pools) {
+        for (auto &pool : pools->pools) {
+            // Frees the sets of the pool along
+            vkDestroyDescriptorPool(m_device, pool->pool, m_callbacks);
+        }
+    }
+    for (auto &[key, layout] : m_layouts) {
+        vkDestroyDescriptorSetLayout(m_device, layout, m_callbacks);
+    }
+    for (auto &[info, sampler] : m_samplers) {
+        vkDestroySampler(m_device, sampler, m_callbacks);
+    }
+}
+
+VkDescriptorSetLayout DescriptorCache::layout(
+    std::span<const VkDescriptorSetLayoutBinding> bindings,
+    VkDescriptorSetLayoutCreateFlags flags) noexcept
+try {
+    LayoutKey key{flags, {}};
+    key.bindings.reserve(bindings.size());
+    for (const VkDescriptorSetLayoutBinding &binding : bindings) {
+        Binding &entry = key.bindings.emplace_back(Binding{
+            binding.binding,
+            binding.descriptorType,
+            binding.descriptorCount,
+            binding.stageFlags,
+            {}});
+        bool samplers = binding.descriptorType == VK_DESCRIPTOR_TYPE_SAMPLER ||
+                        binding.descriptorType ==
+                            VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        if (samplers && binding.pImmutableSamplers != nullptr) {
+            entry.immutable_samplers.assign(
+                binding.pImmutableSamplers,
+                binding.pImmutableSamplers + binding.descriptorCount);
+        }
+    }
+    std::ranges::sort(key.bindings, {}, &Binding::binding);
+
+    {
+        std::shared_lock lock(m_layouts_lock);
+        auto found = m_layouts.find(key);
+        if (found != std::end(m_layouts)) {
+            m_layout_counters.hits.fetch_add(1, std::memory_order_relaxed);
+            return found->second;
+        }
+    }
+    m_layout_counters.misses.fetch_add(1, std::memory_order_relaxed);
+
+    auto pools = std::make_unique<LayoutPools>();
+    for (const Binding &binding : key.bindings) {
+        auto same_type = std::ranges::find(
+            pools->set_sizes, binding.type, &VkDescriptorPoolSize::type);
+        if (same_type != std::end(pools->set_sizes)) {
+            same_type->descriptorCount += binding.count;
+        } else if (binding.count != 0) {
+            pools->set_sizes.emplace_back(
+                VkDescriptorPoolSize{binding.type, binding.count});
+        }
+    }
+    if (flags & VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT) {
+        pools->flags |= VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+    }
+    pools->next_capacity = first_pool_sets;
+
+    VkDescriptorSetLayoutCreateInfo create_info{};
+    create_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    create_info.flags = flags;
+    create_info.bindingCount = static_cast<uint32_t>(bindings.size());
+    create_info.pBindings = bindings.data();
+
+    VkDescriptorSetLayout new_layout = VK_NULL_HANDLE;
+    VkResult status = vkCreateDescriptorSetLayout(
+        m_device, &create_info, m_callbacks, &new_layout);
+    if (status != VK_SUCCESS) {
+        l.warning(
+            "Descriptor set layout creation failue: {}", vk_to_str(status));
+        return VK_NULL_HANDLE;
+    }
+
+    std::unique_lock lock(m_layouts_lock);
+    auto [entry, inserted] = m_layouts.try_emplace(std::move(key), new_layout);
+    if (!inserted) {
+        // Another thread created the same layout meanwhile
+        vkDestroyDescriptorSetLayout(m_device, new_layout, m_callbacks);
+        return entry->second;
+    }
+    m_layout_pools.emplace(new_layout, std::move(pools));
+    return new_layout;
+} catch (...) {
+    l.warning("Descriptor set layout creation failue: Out of host memory");
+    return VK_NULL_HANDLE;
+}
+
+VkSampler DescriptorCache::sampler(
+    const VkSamplerCreateInfo &create_info) noexcept
+try {
+    if (create_info.pNext != nullptr) {
+        l.warning("Sampler creation failue: Extension chains not supported");
+        return VK_NULL_HANDLE;
+    }
+
+    {
+        std::shared_lock lock(m_samplers_lock);
+        auto found = m_samplers.find(create_info);
+        if (found != std::end(m_samplers)) {
+            m_sampler_counters.hits.fetch_add(1, std::memory_order_relaxed);
+            return found->second;
+        }
+    }
+    m_sampler_counters.misses.fetch_add(1, std::memory_order_relaxed);
+
+    VkSampler new_sampler = VK_NULL_HANDLE;
+    VkResult status =
+        vkCreateSampler(m_device, &create_info, m_callbacks, &new_sampler);
+    if (status != VK_SUCCESS) {
+        l.warning("Sampler creation failue: {}", vk_to_str(status));
+        return VK_NULL_HANDLE;
+    }
+
+    std::unique_lock lock(m_samplers_lock);
+    auto [entry, inserted] = m_samplers.try_emplace(create_info, new_sampler);
+    if (!inserted) {
+        vkDestroySampler(m_device, new_sampler, m_callbacks);
+    }
+    return entry->second;
+} catch (...) {
+    l.warning("Sampler creation failue: Out of host memory");
+    return VK_NULL_HANDLE;
+}
+
+DescriptorCache::LayoutPools *
+    DescriptorCache::layout_pools(VkDescriptorSetLayout layout)
+{
+    std::shared_lock lock(m_layouts_lock);
+    auto found = m_layout_pools.find(layout);
+    if (found == std::end(m_layout_pools)) {
+        return nullptr;
+    }
+    return found->second.get();
+}
+
+void DescriptorCache::recycle(LayoutPools &pools, Pool &pool) noexcept
+{
+    if (pool.used != 0) {
+        // Fails only on bugs, the sets are gone either way
+        vkResetDescriptorPool(m_device, pool.pool, 0);
+        m_pool_resets.fetch_add(1, std::memory_order_relaxed);
+        m_reset_sets.fetch_add(pool.used, std::memory_order_relaxed);
+    }
+    for (uint64_t key : pool.set_keys) {
+        auto found = pools.sets.find(key);
+        if (found != std::end(pools.sets) && found->second.pool == &pool) {
+            pools.sets.erase(found);
+        }
+    }
+    pool.set_keys.clear();
+    pool.epochs.clear();
+    pool.used = 0;
+}
+
+DescriptorCache::Pool *DescriptorCache::next_pool(LayoutPools &pools)
+{
+    // Pools whose epochs completed are reset rather than adding one
+    auto reusable = std::ranges::find_if(pools.pools, [](const auto &pool) {
+        return !pool->touched &&
+               std::ranges::all_of(pool->epochs, [](const Epoch &epoch) {
+                   return epoch.timeline->completed() >= epoch.value;
+               });
+    });
+    if (reusable != std::end(pools.pools)) {
+        recycle(pools, **reusable);
+        std::rotate(reusable, std::next(reusable), std::end(pools.pools));
+        return pools.pools.back().get();
+    }
+
+    auto pool = std::make_unique<Pool>();
+    pool->capacity = pools.next_capacity;
+    pools.next_capacity = std::min(pools.next_capacity * 2, max_pool_sets);
+
+    std::vector<VkDescriptorPoolSize> sizes = pools.set_sizes;
+    for (VkDescriptorPoolSize &size : sizes) {
+        size.descriptorCount *= pool->capacity;
+    }
+    VkDescriptorPoolCreateInfo create_info{};
+    create_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    create_info.flags = pools.flags;
+    create_info.maxSets = pool->capacity;
+    create_info.poolSizeCount = static_cast<uint32_t>(sizes.size());
+    create_info.pPoolSizes = sizes.data();
+
+    VkResult status = vkCreateDescriptorPool(
+        m_device, &create_info, m_callbacks, &pool->pool);
+    if (status != VK_SUCCESS) {
+        l.warning("Descriptor pool creation failue: {}", vk_to_str(status));
+        return nullptr;
+    }
+    m_nb_pools.fetch_add(1, std::memory_order_relaxed);
+    return pools.pools.emplace_back(std::move(pool)).get();
+}
+
+VkDescriptorSet DescriptorCache::allocate(
+    LayoutPools &pools, VkDescriptorSetLayout layout, Pool *&pool)
+{
+    pool = pools.pools.empty() ? nullptr : pools.pools.back().get();
+    // A second try on a fresh pool if the driver disagrees on the room
+    for (size_t attempt = 0; attempt < 2; attempt++) {
+        if (pool == nullptr || pool->used == pool->capacity) {
+            pool = next_pool(pools);
+            if (pool == nullptr) {
+                return VK_NULL_HANDLE;
+            }
+        }
+
+        VkDescriptorSetAllocateInfo allocate_info{};
+        allocate_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocate_info.descriptorPool = pool->pool;
+        allocate_info.descriptorSetCount = 1;
+        allocate_info.pSetLayouts = &layout;
+
+        VkDescriptorSet set = VK_NULL_HANDLE;
+        VkResult status =
+            vkAllocateDescriptorSets(m_device, &allocate_info, &set);
+        if (status == VK_SUCCESS) {
+            pool->used++;
+            pool->touched = true;
+            return set;
+        }
+        if (status != VK_ERROR_OUT_OF_POOL_MEMORY &&
+            status != VK_ERROR_FRAGMENTED_POOL) {
+            l.warning(
+                "Descriptor set allocation failue: {}", vk_to_str(status));
+            return VK_NULL_HANDLE;
+        }
+        pool->used = pool->capacity;
+    }
+    l.warning("Descriptor set allocation failue: Pool exhausted");
+    return VK_NULL_HANDLE;
+}
+
+VkDescriptorSet DescriptorCache::set(
+    VkDescriptorSetLayout layout,
+    std::span<const DescriptorWrite> writes) noexcept
+try {
+    LayoutPools *pools = layout_pools(layout);
+    if (pools == nullptr) {
+        l.warning("Descriptor set allocation failue: Unknown layout");
+        return VK_NULL_HANDLE;
+    }
+
+    Hasher hasher;
+    for (const DescriptorWrite &write : writes) {
+        hash_write(hasher, write);
+    }
+    uint64_t key = hasher.hash;
+
+    std::lock_guard lock(pools->lock);
+    auto found = pools->sets.find(key);
+    if (found != std::end(pools->sets) &&
+        std::ranges::equal(found->second.writes, writes, same_write)) {
+        m_set_counters.hits.fetch_add(1, std::memory_order_relaxed);
+        found->second.pool->touched = true;
+        return found->second.set;
+    }
+    m_set_counters.misses.fetch_add(1, std::memory_order_relaxed);
+
+    Pool *pool = nullptr;
+    VkDescriptorSet set = allocate(*pools, layout, pool);
+    if (set == VK_NULL_HANDLE) {
+        return VK_NULL_HANDLE;
+    }
+
+    std::vector<VkWriteDescriptorSet> updates(writes.size());
+    for (size_t idx = 0; idx < writes.size(); idx++) {
+        const DescriptorWrite &write = writes[idx];
+        VkWriteDescriptorSet &update = updates[idx];
+        update.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        update.dstSet = set;
+        update.dstBinding = write.binding;
+        update.dstArrayElement = write.array_element;
+        update.descriptorCount = 1;
+        update.descriptorType = write.type;
+        if (uses_image_info(write.type)) {
+            update.pImageInfo = &write.image;
+        } else if (uses_texel_view(write.type)) {
+            update.pTexelBufferView = &write.texel_view;
+        } else {
+            update.pBufferInfo = &write.buffer;
+        }
+    }
+    vkUpdateDescriptorSets(
+        m_device,
+        static_cast<uint32_t>(updates.size()),
+        updates.data(),
+        0,
+        nullptr);
+
+    std::vector<DescriptorWrite> content(std::begin(writes), std::end(writes));
+    pools->sets.insert_or_assign(key, CachedSet{set, pool, std::move(content)});
+    pool->set_keys.emplace_back(key);
+    return set;
+} catch (...) {
+    l.warning("Descriptor set allocation failue: Out of host memory");
+    return VK_NULL_HANDLE;
+}
+
+VkDescriptorSet DescriptorCache::allocate(VkDescriptorSetLayout layout) noexcept
+try {
+    LayoutPools *pools = layout_pools(layout);
+    if (pools == nullptr) {
+        l.warning("Descriptor set allocation failue: Unknown layout");
+        return VK_NULL_HANDLE;
+    }
+
+    std::lock_guard lock(pools->lock);
+    Pool *pool = nullptr;
+    return allocate(*pools, layout, pool);
+} catch (...) {
+    l.warning("Descriptor set allocation failue: Out of host memory");
+    return VK_NULL_HANDLE;
+}
+
+void DescriptorCache::retire(
+    std::shared_ptr<Timeline> timeline, uint64_t value) noexcept
+try {
+    std::shared_lock layouts_lock(m_layouts_lock);
+    for (auto &[layout, pools] : m_layout_pools) {
+        std::lock_guard lock(pools->lock);
+        for (auto &pool : pools->pools) {
+            if (!pool->touched) {
+                continue;
+            }
+            auto same = std::ranges::find(
+                pool->epochs, timeline, &Epoch::timeline);
+            if (same != std::end(pool->epochs)) {
+                same->value = std::max(same->value, value);
+            } else {
+                pool->epochs.emplace_back(Epoch{timeline, value});
+            }
+            pool->touched = false;
+        }
+    }
+} catch (...) {
+    // Left touched: the pools wait for the next retire instead
+    l.warning("Descriptor pool retire failue: Out of host memory");
+}
+
+void DescriptorCache::forget_sets() noexcept
+{
+    std::shared_lock layouts_lock(m_layouts_lock);
+    for (auto &[layout, pools] : m_layout_pools) {
+        std::lock_guard lock(pools->lock);
+        pools->sets.clear();
+        for (auto &pool : pools->pools) {
+            pool->set_keys.clear();
+        }
+    }
+}
+
+DescriptorCacheStats DescriptorCache::stats() const noexcept
+{
+    auto snapshot = [](const Counters &counters) {
+        DescriptorCacheStats::Counters taken;
+        taken.hits = counters.hits.load(std::memory_order_relaxed);
+        taken.misses = counters.misses.load(std::memory_order_relaxed);
+        return taken;
+    };
+
+    DescriptorCacheStats stats;
+    stats.layouts = snapshot(m_layout_counters);
+    stats.samplers = snapshot(m_sampler_counters);
+    stats.sets = snapshot(m_set_counters);
+    {
+        std::shared_lock layouts_lock(m_layouts_lock);
+        stats.layouts.cached = m_layouts.size();
+        for (auto &[layout, pools] : m_layout_pools) {
+            std::lock_guard lock(pools->lock);
+            stats.sets.cached += pools->sets.size();
+        }
+    }
+    {
+        std::shared_lock lock(m_samplers_lock);
+        stats.samplers.cached = m_samplers.size();
+    }
+    stats.pools = m_nb_pools.load(std::memory_order_relaxed);
+    stats.pool_resets = m_pool_resets.load(std::memory_order_relaxed);
+    stats.reset_sets = m_reset_sets.load(std::memory_order_relaxed);
+    return stats;
+}
+
+} // namespace pvk
@@ -0,0 +1,185 @@
+#include <cstring>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+#include <pvk/log.hh>
+#include <pvk/logger.hh>
+
+#include "pvk/internal/descriptor_cache.hh"
+#include "pvk/internal/descriptor_template.hh"
+#include "pvk/internal/result.hh"
+#include "pvk/internal/vk_api.hh"
+
+namespace pvk {
+
+DescriptorTemplate::DescriptorTemplate(
+    VkDevice device,
+    VkPipelineBindPoint bind_point,
+    DescriptorCache &cache,
+    const VkAllocationCallbacks *callbacks)
+    : m_device(device), m_bind_point(bind_point), m_cache(cache),
+      m_callbacks(callbacks)
+{
+    l.set_name("DescriptorTemplate");
+}
+
+DescriptorTemplate::~DescriptorTemplate()
+{
+    vkDestroyDescriptorUpdateTemplate(m_device, m_template, m_callbacks);
+    vkDestroyPipelineLayout(m_device, m_pipeline_layout, m_callbacks);
+}
+
+std::unique_ptr<DescriptorTemplate> DescriptorTemplate::create(
+    VkDevice device,
+    uint32_t api_version,
+    std::span<const Entry> entries,
+    VkPipelineBindPoint bind_point,
+    DescriptorCache &cache,
+    PFN_PushDescriptorSetWithTemplate push,
+    const VkAllocationCallbacks *callbacks) noexcept
+try {
+    std::unique_ptr<DescriptorTemplate> parameters(
+        new DescriptorTemplate(device, bind_point, cache, callbacks));
+    Logger &l = parameters->l;
+
+    std::vector<VkDescriptorSetLayoutBinding> bindings;
+    std::vector<VkDescriptorUpdateTemplateEntry> template_entries;
+    uint32_t nb_descriptors = 0;
+    for (const Entry &entry : entries) {
+        VkDescriptorSetLayoutBinding &binding = bindings.emplace_back();
+        binding.binding = entry.binding;
+        binding.descriptorType = entry.type;
+        binding.descriptorCount = entry.count;
+        binding.stageFlags = VK_SHADER_STAGE_ALL;
+
+        VkDescriptorUpdateTemplateEntry &template_entry =
+            template_entries.emplace_back();
+        template_entry.dstBinding = entry.binding;
+        template_entry.descriptorCount = entry.count;
+        template_entry.descriptorType = entry.type;
+        template_entry.offset = entry.offset;
+        template_entry.stride = entry.stride;
+        nb_descriptors += entry.count;
+    }
+
+    bool templates = api_version >= VK_API_VERSION_1_1;
+    if (templates && push != nullptr &&
+        nb_descriptors <= min_max_push_descriptors) {
+        parameters->m_push = push;
+    }
+    VkDescriptorSetLayoutCreateFlags layout_flags =
+        parameters->pushes() ? push_descriptor_layout_bit : 0;
+    parameters->m_set_layout = cache.layout(bindings, layout_flags);
+    if (parameters->m_set_layout == VK_NULL_HANDLE) {
+        return nullptr;
+    }
+
+    VkPipelineLayoutCreateInfo layout_info{};
+    layout_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    layout_info.setLayoutCount = 1;
+    layout_info.pSetLayouts = &parameters->m_set_layout;
+    VkResult status = vkCreatePipelineLayout(
+        device, &layout_info, callbacks, &parameters->m_pipeline_layout);
+    if (status != VK_SUCCESS) {
+        l.warning("Pipeline layout creation failue: {}", vk_to_str(status));
+        return nullptr;
+    }
+
+    if (!templates) {
+        parameters->m_entries.assign(std::begin(entries), std::end(entries));
+        return parameters;
+    }
+
+    VkDescriptorUpdateTemplateCreateInfo template_info{};
+    template_info.sType =
+        VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO;
+    template_info.descriptorUpdateEntryCount =
+        static_cast<uint32_t>(template_entries.size());
+    template_info.pDescriptorUpdateEntries = template_entries.data();
+    template_info.templateType =
+        VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET;
+    if (parameters->pushes()) {
+        template_info.templateType = push_descriptors_template;
+    }
+    template_info.descriptorSetLayout = parameters->m_set_layout;
+    template_info.pipelineBindPoint = bind_point;
+    template_info.pipelineLayout = parameters->m_pipeline_layout;
+    template_info.set = 0;
+    status = vkCreateDescriptorUpdateTemplate(
+        device, &template_info, callbacks, &parameters->m_template);
+    if (status != VK_SUCCESS) {
+        l.warning(
+            "Descriptor update template creation failue: {}",
+            vk_to_str(status));
+        return nullptr;
+    }
+    return parameters;
+} catch (...) {
+    pvk::warning("Descriptor update template failue: Out of host memory");
+    return nullptr;
+}
+
+bool DescriptorTemplate::bind(
+    VkCommandBuffer buffer, const void *parameters) noexcept
+try {
+    if (m_push != nullptr) {
+        m_push(buffer, m_template, m_pipeline_layout, 0, parameters);
+        return true;
+    }
+
+    VkDescriptorSet set = VK_NULL_HANDLE;
+    if (m_template != VK_NULL_HANDLE) {
+        set = m_cache.allocate(m_set_layout);
+        if (set != VK_NULL_HANDLE) {
+            vkUpdateDescriptorSetWithTemplate(
+                m_device, set, m_template, parameters);
+        }
+    } else {
+        set = cached_set(parameters);
+    }
+    if (set == VK_NULL_HANDLE) {
+        return false;
+    }
+    vkCmdBindDescriptorSets(
+        buffer, m_bind_point, m_pipeline_layout, 0, 1, &set, 0, nullptr);
+    return true;
+} catch (...) {
+    l.warning("Parameters binding failue: Out of host memory");
+    return false;
+}
+
+VkDescriptorSet DescriptorTemplate::cached_set(const void *parameters)
+{
+    const auto *bytes = static_cast<const std::byte *>(parameters);
+    std::vector<DescriptorWrite> writes;
+    for (const Entry &entry : m_entries) {
+        for (uint32_t idx = 0; idx < entry.count; idx++) {
+            const std::byte *source = bytes + entry.offset + idx * entry.stride;
+            DescriptorWrite &write = writes.emplace_back();
+            write.binding = entry.binding;
+            write.array_element = idx;
+            write.type = entry.type;
+            switch (entry.type) {
+            case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+            case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+                std::memcpy(&write.buffer, source, sizeof(write.buffer));
+                break;
+            case VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER:
+            case VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER:
+                std::memcpy(
+                    &write.texel_view, source, sizeof(write.texel_view));
+                break;
+            default:
+                std::memcpy(&write.image, source, sizeof(write.image));
+                break;
+            }
+        }
+    }
+    return m_cache.set(m_set_layout, writes);
+}
+
+} // namespace pvk
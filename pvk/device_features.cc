@@ -0,0 +1,76 @@
+#include <array>
+#include <string_view>
+
+#include <cstddef>
+#include <cstdint>
+
+#include <pvk/device_features.hh>
+
+#include "pvk/internal/device_features.hh"
+#include "pvk/internal/vk_api.hh"
+
+namespace {
+
+constexpr std::array<std::string_view, pvk::device_feature_count>
+    feature_names{
+        "shader_float64",
+        "shader_int64",
+        "shader_int16",
+        "storage_buffer_16bit",
+        "uniform_buffer_16bit",
+        "push_constant_16bit",
+        "shader_float16",
+        "shader_int8",
+        "storage_buffer_8bit",
+        "uniform_buffer_8bit",
+        "push_constant_8bit",
+        "shader_buffer_int64_atomics",
+        "subgroup_extended_types",
+        "scalar_block_layout",
+        "buffer_device_address",
+        "timeline_semaphore",
+        "vulkan_memory_model",
+        "host_query_reset",
+        "synchronization2",
+        "subgroup_size_control",
+        "compute_full_subgroups",
+        "integer_dot_product",
+        "zero_initialize_workgroup_memory",
+        "maintenance4",
+    };
+
+} // namespace
+
+namespace pvk {
+
+DeviceFeatureChain::DeviceFeatureChain()
+{
+    features_11.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_1_FEATURES;
+    features_12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+    features_13.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+}
+
+void DeviceFeatureChain::link(
+    VkDeviceCreateInfo &create_info, uint32_t api_version)
+{
+    create_info.pEnabledFeatures = &features;
+    if (api_version < VK_API_VERSION_1_2) {
+        return;
+    }
+    create_info.pNext = &features_11;
+    features_11.pNext = &features_12;
+    if (api_version >= VK_API_VERSION_1_3) {
+        features_12.pNext = &features_13;
+    }
+}
+
+std::string_view feature_name(DeviceFeature feature)
+{
+    size_t feature_idx = static_cast<size_t>(feature);
+    if (feature_idx >= feature_names.size()) {
+        return "unknown feature";
+    }
+    return feature_names[feature_idx];
+}
+
+} // namespace pvk
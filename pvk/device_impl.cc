@@ -4,7 +4,7 @@
 #include <iterator>
 #include <limits>
 #include <memory>
-#include <numeric>
+#include <memory_resource>
 #include <optional>
 #include <span>
 #include <string>
@@ -18,25 +18,35 @@
 #include <cstdint>
 
 #include <pvk/device.hh>
+#include <pvk/device_features.hh>
+#include <pvk/gpu_future.hh>
 #include <pvk/instance.hh>
 #include <pvk/log.hh>
 #include <pvk/logger.hh>
+#include <pvk/queue_plan.hh>
 
+#include "pvk/internal/bindless_table.hh"
+#include "pvk/internal/command_pools.hh"
+#include "pvk/internal/device_features.hh"
 #include "pvk/internal/device_impl.hh"
 #include "pvk/internal/device_queue_string.hh"
+#include "pvk/internal/descriptor_cache.hh"
+#include "pvk/internal/descriptor_template.hh"
 #include "pvk/internal/layer_utils.hh"
 #include "pvk/internal/log_utils.hh"
+#include "pvk/internal/numa.hh"
+#include "pvk/internal/physical_device_info.hh"
+#include "pvk/internal/queue_selection.hh"
 #include "pvk/internal/result.hh"
 #include "pvk/internal/string_pack.hh"
+#include "pvk/internal/submit_ring.hh"
+#include "pvk/internal/sync_pools.hh"
+#include "pvk/internal/timeline.hh"
 #include "pvk/internal/vk_allocator.hh"
 #include "pvk/internal/vk_api.hh"
 
-constexpr float DEFAULT_QUEUE_PRIORITY = 1.0;
-
 #define IMPL Impl::cast_from(*this)
 
-using vkQueueIndex_t = decltype(VkQueueFamilyProperties::queueCount);
-
 /*
  * based on
  * https://stackoverflow.com/questions/43526647/decltype-of-function-parameter
@@ -70,6 +80,10 @@ namespace {
 void dump_queue_families(
     const std::vector<VkQueueFamilyProperties> &families, Logger &l)
 {
+    if (!l.enabled(Logger::Level::INFO)) {
+        return;
+    }
+
     for (vkQueueFamIndex_t q_fam_idx = 0; q_fam_idx < families.size();
          q_fam_idx++) {
         auto &family = families[q_fam_idx];
@@ -133,10 +147,69 @@ void dump_queue_families(
 
 bool Device::connect()
 {
-    return IMPL.connect();
+    return IMPL.connect(std::pmr::get_default_resource());
 }
 
-bool Device::Impl::connect()
+bool Device::connect(std::pmr::memory_resource *scratch)
+{
+    if (scratch == nullptr) {
+        scratch = std::pmr::get_default_resource();
+    }
+    return IMPL.connect(scratch);
+}
+
+bool Device::connect(const QueuePlan &plan, std::pmr::memory_resource *scratch)
+{
+    if (scratch == nullptr) {
+        scratch = std::pmr::get_default_resource();
+    }
+    return IMPL.connect(plan, scratch);
+}
+
+bool Device::connect(
+    const DeviceFeatureRequest &features, std::pmr::memory_resource *scratch)
+{
+    if (scratch == nullptr) {
+        scratch = std::pmr::get_default_resource();
+    }
+    return IMPL.connect(
+        default_queue_plan(IMPL.get_queue_families()), features, scratch);
+}
+
+bool Device::connect(
+    const QueuePlan &plan,
+    const DeviceFeatureRequest &features,
+    std::pmr::memory_resource *scratch)
+{
+    if (scratch == nullptr) {
+        scratch = std::pmr::get_default_resource();
+    }
+    return IMPL.connect(plan, features, scratch);
+}
+
+bool Device::Impl::connect(std::pmr::memory_resource *scratch)
+{
+    return connect(default_queue_plan(get_queue_families()), scratch);
+}
+
+bool Device::Impl::connect(
+    const QueuePlan &plan, std::pmr::memory_resource *scratch)
+{
+    return connect(plan, DeviceFeatureRequest{}, scratch);
+}
+
+bool Device::Impl::supports(DeviceFeature feature) const
+{
+    if (static_cast<size_t>(feature) >= device_feature_count) {
+        return false;
+    }
+    return feature_flag(*m_info, feature) == VK_TRUE;
+}
+
+bool Device::Impl::connect(
+    const QueuePlan &plan,
+    const DeviceFeatureRequest &request,
+    std::pmr::memory_resource *scratch)
 {
     static_assert(
         std::is_same_v<Queue::FamilyIndex, vkQueueFamIndex_t>,
@@ -147,20 +220,20 @@ bool Device::Impl::connect()
         return false;
     }
 
-    std::unordered_set<std::string> full_extesions_list;
-    std::vector<std::string_view> enabled_layers;
-    std::vector<std::string_view> enabled_extensions;
+    NameSet full_extesions_list(scratch);
+    std::pmr::vector<std::string_view> enabled_layers(scratch);
+    std::pmr::vector<std::string_view> enabled_extensions(scratch);
 
-    auto implicit_extensions =
-        get_device_layer_extensions(m_phy_device, nullptr, l);
-    for (auto &implicit_extension : implicit_extensions) {
-        full_extesions_list.emplace(std::move(implicit_extension));
+    // Enumerated once by the instance, or restored from its cache
+    for (const auto &implicit_extension : m_info->extensions) {
+        full_extesions_list.emplace(implicit_extension.extensionName);
     }
 
-    std::unordered_set<std::string> device_layers =
-        get_device_layers(m_phy_device, l);
-    auto device_ext_map =
-        get_device_layers_extensions(m_phy_device, device_layers, l);
+    NameSet device_layers(scratch);
+    for (const auto &layer : m_info->layers) {
+        device_layers.emplace(layer.layer);
+    }
+    auto device_ext_map = to_layer_map(m_info->layers, scratch);
 
     for (auto &layer : device_ext_map) {
         for (auto &layer_ext_name : layer.second) {
@@ -177,14 +250,18 @@ bool Device::Impl::connect()
     }
 #endif
 
-    std::string device_name = get_name();
-    dump_extensions_per_layer(
-        device_ext_map, std::format("{} layers", device_name), l);
+    // Boxes are only rendered for a sink that prints them
+    bool dump_boxes = l.enabled(Logger::Level::INFO);
+    std::string device_name = dump_boxes ? get_name() : std::string();
+    if (dump_boxes) {
+        dump_extensions_per_layer(
+            device_ext_map, std::format("{} layers", device_name), l);
+    }
 
-    if (full_extesions_list.size() != 0) {
+    if (dump_boxes && full_extesions_list.size() != 0) {
         std::string label = std::format("{} extensions", device_name);
         size_t max_line_size = label.size();
-        std::vector<std::string> lines;
+        std::pmr::vector<std::string_view> lines(scratch);
         lines.reserve(full_extesions_list.size());
 
         std::ranges::copy(full_extesions_list, std::back_inserter(lines));
@@ -205,11 +282,62 @@ bool Device::Impl::connect()
         l.info("{}", box_foot(max_line_size));
     }
 
+    DeviceFeatureChain enabled_features;
+    for (DeviceFeature feature : request.required) {
+        if (!supports(feature)) {
+            l.warning(
+                "Device connection failue: Feature {} is not supported",
+                feature_name(feature));
+            return false;
+        }
+        feature_flag(enabled_features, feature) = VK_TRUE;
+    }
+    for (DeviceFeature feature : request.optional) {
+        if (!supports(feature)) {
+            l.notice(
+                "Feature {} is not supported: Go without it",
+                feature_name(feature));
+            continue;
+        }
+        feature_flag(enabled_features, feature) = VK_TRUE;
+    }
+
+    auto enable_extension = [&](std::string_view name) {
+        if (std::ranges::find(enabled_extensions, name) ==
+            std::end(enabled_extensions)) {
+            enabled_extensions.emplace_back(name);
+        }
+    };
+    for (const std::string &name : request.required_extensions) {
+        if (!m_info->has_extension(name)) {
+            l.warning(
+                "Device connection failue: Extension {} is not supported",
+                name);
+            return false;
+        }
+        enable_extension(name);
+    }
+    for (const std::string &name : request.optional_extensions) {
+        if (!m_info->has_extension(name)) {
+            l.notice("Extension {} is not supported: Go without it", name);
+            continue;
+        }
+        enable_extension(name);
+    }
+
+    // Pipelines push their parameters instead of writing sets with it. It
+    // needs VK_KHR_get_physical_device_properties2, core from 1.1
+    bool push_descriptors = m_info->api_version >= VK_API_VERSION_1_1 &&
+        m_info->has_extension(push_descriptor_extension);
+    if (push_descriptors) {
+        enable_extension(push_descriptor_extension);
+    }
+
     auto enabled_layer_names =
-        utils::StringPack::create(std::span(enabled_layers));
+        utils::StringPack::create(std::span(enabled_layers), scratch);
 
     auto enabled_ext_names =
-        utils::StringPack::create(std::span(enabled_extensions));
+        utils::StringPack::create(std::span(enabled_extensions), scratch);
     if (!enabled_layer_names || !enabled_ext_names) {
         l.warning(
             "Device connection failue: No host memory for connection info");
@@ -218,39 +346,49 @@ bool Device::Impl::connect()
     auto enabled_layers_names_ptrs = enabled_layer_names->get();
     auto enabled_extension_names_ptrs = enabled_ext_names->get();
 
-    std::vector<VkQueueFamilyProperties> families = get_queue_families();
+    const std::vector<VkQueueFamilyProperties> &families = get_queue_families();
     dump_queue_families(families, l);
 
     if (families.size() == 0) {
         l.warning("No single queue family (WAT?)");
     }
 
+    std::optional<QueueSelection> selection =
+        select_queues(plan, families, l);
+    if (!selection) {
+        l.warning("Device connection failue: Queue plan cannot be served");
+        return false;
+    }
+
     VkDeviceQueueCreateInfo empty_q_create_info{};
     empty_q_create_info.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
-    std::vector<VkDeviceQueueCreateInfo> q_create_infos;
-    q_create_infos.resize(families.size());
-
-    std::vector<std::vector<float>> q_create_infos_priors_storage;
-    q_create_infos_priors_storage.resize(families.size());
+    std::pmr::vector<VkDeviceQueueCreateInfo> q_create_infos(scratch);
+
+    // Slots of a family carry queue indices 0..N-1
+    std::pmr::vector<std::pmr::vector<float>> q_create_infos_priors_storage(
+        families.size(), scratch);
+    for (const auto &slot : selection->slots) {
+        auto &q_priors = q_create_infos_priors_storage[slot.family_idx];
+        q_priors.resize(std::max<size_t>(q_priors.size(), slot.queue_idx + 1));
+        q_priors[slot.queue_idx] = slot.priority;
+    }
 
-    std::ranges::fill(q_create_infos, empty_q_create_info);
     for (vkQueueFamIndex_t q_fam_idx = 0; q_fam_idx < families.size();
          q_fam_idx++) {
-        VkQueueFamilyProperties &q_fam_props = families[q_fam_idx];
-        VkDeviceQueueCreateInfo &q_create_info = q_create_infos[q_fam_idx];
+        auto &q_priors = q_create_infos_priors_storage[q_fam_idx];
+        if (q_priors.empty()) {
+            continue;
+        }
+        VkDeviceQueueCreateInfo &q_create_info =
+            q_create_infos.emplace_back(empty_q_create_info);
         q_create_info.queueFamilyIndex = q_fam_idx;
-        q_create_info.queueCount = q_fam_props.queueCount;
+        q_create_info.queueCount = q_priors.size();
         q_create_info.flags = 0;
-        auto &q_priors = q_create_infos_priors_storage[q_fam_idx];
-        q_priors.resize(q_create_info.queueCount);
-        std::ranges::fill(q_priors, DEFAULT_QUEUE_PRIORITY);
         q_create_info.pQueuePriorities = q_priors.data();
     }
 
     VkDeviceCreateInfo create_info{};
     create_info.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
-    VkPhysicalDeviceFeatures device_features{};
-    create_info.pEnabledFeatures = &device_features;
     create_info.pQueueCreateInfos = q_create_infos.data();
     create_info.queueCreateInfoCount = q_create_infos.size();
     create_info.ppEnabledLayerNames = enabled_layers_names_ptrs.data();
@@ -258,6 +396,20 @@ bool Device::Impl::connect()
     create_info.enabledExtensionCount = enabled_extension_names_ptrs.size();
     create_info.ppEnabledExtensionNames = enabled_extension_names_ptrs.data();
 
+    // Queue timelines fall back to fences without it
+    bool timeline_semaphores = supports(DeviceFeature::TIMELINE_SEMAPHORE);
+    if (timeline_semaphores) {
+        enabled_features.features_12.timelineSemaphore = VK_TRUE;
+    }
+    bool bindless = BindlessTable::supported(*m_info);
+    if (bindless) {
+        BindlessTable::enable(enabled_features.features_12);
+    }
+    enabled_features.link(create_info, m_info->api_version);
+
+    std::vector<std::string> granted_extensions(
+        std::begin(enabled_extensions), std::end(enabled_extensions));
+
     VkDevice new_logical_device = VK_NULL_HANDLE;
     VkResult create_device_status = vkCreateDevice(
         m_phy_device,
@@ -272,41 +424,95 @@ bool Device::Impl::connect()
     }
 
     std::vector<Queue> queue_list;
-    vkQueueIndex_t total_queue_count = std::accumulate(
-        begin(families),
-        end(families),
-        0,
-        [](vkQueueIndex_t acc, const VkQueueFamilyProperties &family) {
-            return acc + family.queueCount;
-        });
-
-    queue_list.reserve(total_queue_count);
-
-    for (vkQueueFamIndex_t q_fam_idx = 0; q_fam_idx < families.size();
-         q_fam_idx++) {
-        const VkQueueFamilyProperties &q_fam = families[q_fam_idx];
-        vkQueueIndex_t current_qfam_nb_qs = q_fam.queueCount;
-
-        for (vkQueueIndex_t q_in_family_index = 0;
-             q_in_family_index < current_qfam_nb_qs;
-             q_in_family_index++) {
-
-            VkQueue next_queue{};
-
-            vkGetDeviceQueue(
-                new_logical_device, q_fam_idx, q_in_family_index, &next_queue);
+    queue_list.reserve(selection->slots.size());
+    for (const auto &slot : selection->slots) {
+        VkQueue next_queue{};
+        vkGetDeviceQueue(
+            new_logical_device, slot.family_idx, slot.queue_idx, &next_queue);
+
+        Queue next_device_queue;
+        next_device_queue.queue = next_queue;
+        next_device_queue.family_idx = slot.family_idx;
+        next_device_queue.idx = slot.queue_idx;
+        next_device_queue.users = slot.users;
+
+        queue_list.emplace_back(std::move(next_device_queue));
+    }
 
-            Queue next_device_queue;
-            next_device_queue.queue = next_queue;
-            next_device_queue.family_idx = q_fam_idx;
-            next_device_queue.idx = q_in_family_index;
+    PFN_PushDescriptorSetWithTemplate push_descriptor = nullptr;
+    if (push_descriptors) {
+        push_descriptor = reinterpret_cast<PFN_PushDescriptorSetWithTemplate>(
+            vkGetDeviceProcAddr(
+                new_logical_device, "vkCmdPushDescriptorSetWithTemplateKHR"));
+    }
 
-            queue_list.emplace_back(std::move(next_device_queue));
+    std::unique_ptr<SyncPools> sync_pools;
+    std::vector<std::shared_ptr<Timeline>> timelines;
+    std::vector<std::unique_ptr<SubmitRing>> submit_rings;
+    std::unique_ptr<CommandPools> command_pools;
+    std::unique_ptr<DescriptorCache> descriptor_cache;
+    std::unique_ptr<BindlessTable> bindless_table;
+    bool submitters_started = true;
+    try {
+        sync_pools = std::make_unique<SyncPools>(
+            new_logical_device, m_alloc->get_callbacks());
+        timelines.reserve(queue_list.size());
+        submit_rings.reserve(queue_list.size());
+        for (const Queue &queue : queue_list) {
+            std::string queue_name = std::format(
+                "{} queue {}.{}", get_name(), queue.family_idx, queue.idx);
+            auto timeline = Timeline::create(
+                new_logical_device,
+                timeline_semaphores,
+                sync_pools.get(),
+                m_alloc->get_callbacks(),
+                queue_name);
+            if (!timeline) {
+                submitters_started = false;
+                break;
+            }
+            timelines.emplace_back(timeline);
+            submit_rings.emplace_back(std::make_unique<SubmitRing>(
+                queue.queue, std::move(timeline), queue_name));
+        }
+        command_pools = std::make_unique<CommandPools>(
+            new_logical_device, families.size(), m_alloc->get_callbacks());
+        descriptor_cache = std::make_unique<DescriptorCache>(
+            new_logical_device, m_alloc->get_callbacks());
+        // Kernels bind their sets instead when it cannot be created
+        if (bindless) {
+            bindless_table = BindlessTable::create(
+                new_logical_device, *m_info, m_alloc->get_callbacks());
         }
+    } catch (...) {
+        submitters_started = false;
+    }
+    if (!submitters_started) {
+        l.warning("Device connection failue: Cannot start queue submitters");
+        submit_rings.clear();
+        std::ranges::for_each(timelines, [](auto &t) { t->retire(); });
+        sync_pools.reset();
+        vkDestroyDevice(new_logical_device, m_alloc->get_callbacks());
+        return false;
     }
 
     m_device = new_logical_device;
     m_queues = std::move(queue_list);
+    m_submit_rings = std::move(submit_rings);
+    m_command_pools = std::move(command_pools);
+    m_descriptor_cache = std::move(descriptor_cache);
+    m_bindless_table = std::move(bindless_table);
+    m_push_descriptor = push_descriptor;
+    m_sync_pools = std::move(sync_pools);
+    m_queues_by_kind = std::move(selection->by_kind);
+
+    for (size_t feature_idx = 0; feature_idx < device_feature_count;
+         feature_idx++) {
+        auto feature = static_cast<DeviceFeature>(feature_idx);
+        m_enabled_features[feature_idx] =
+            feature_flag(enabled_features, feature) == VK_TRUE;
+    }
+    m_enabled_extensions = std::move(granted_extensions);
 
     return true;
 }
@@ -318,12 +524,102 @@ void Device::Impl::disconnect()
         return;
     }
 
+    // Hand over what is still queued, then let the device drain it
+    std::vector<std::shared_ptr<Timeline>> timelines;
+    for (const auto &ring : m_submit_rings) {
+        timelines.emplace_back(ring->timeline());
+    }
+    m_submit_rings.clear();
+    VkResult idle_status = vkDeviceWaitIdle(m_device);
+    if (idle_status != VK_SUCCESS) {
+        l.warning("Waiting device idle failue: {}", vk_to_str(idle_status));
+    }
+    // Outstanding futures complete, their continuations run here
+    std::ranges::for_each(timelines, [](auto &t) { t->retire(); });
+    m_command_pools.reset();
+    m_bindless_table.reset();
+    m_descriptor_cache.reset();
+    m_push_descriptor = nullptr;
+    m_sync_pools.reset();
+    m_enabled_features.reset();
+    m_enabled_extensions.clear();
+
     if (m_alloc != nullptr) {
         vkDestroyDevice(m_device, m_alloc->get_callbacks());
     } else {
         vkDestroyDevice(m_device, nullptr);
     }
     m_device = VK_NULL_HANDLE;
+    m_queues.clear();
+    std::ranges::for_each(m_queues_by_kind, [](auto &k) { k.clear(); });
+}
+
+GpuFuture Device::queue_future(QueueKind kind, size_t nth) noexcept
+{
+    return IMPL.submit(kind, nth, Submission{});
+}
+
+GpuFuture Device::end_frame(QueueKind kind, size_t nth) noexcept
+{
+    return IMPL.end_frame(kind, nth);
+}
+
+GpuFuture Device::Impl::end_frame(QueueKind kind, size_t nth) noexcept
+{
+    SubmitRing *ring = get_submit_ring(kind, nth);
+    if (ring == nullptr) {
+        l.warning(
+            "No {} queue {}: Ignore frame end", queue_kind_name(kind), nth);
+        return GpuFuture();
+    }
+
+    const auto &kind_slots = m_queues_by_kind[static_cast<size_t>(kind)];
+    uint32_t family_idx = m_queues[kind_slots[nth]].family_idx;
+    uint64_t value = ring->push(Submission{});
+    m_command_pools->retire(family_idx, ring->timeline(), value);
+    m_descriptor_cache->retire(ring->timeline(), value);
+    return GpuFuture(ring->timeline(), value);
+}
+
+GpuFuture Device::Impl::submit(
+    QueueKind kind, size_t nth, const Submission &submission) noexcept
+{
+    SubmitRing *ring = get_submit_ring(kind, nth);
+    if (ring == nullptr) {
+        l.warning(
+            "No {} queue {}: Ignore submission", queue_kind_name(kind), nth);
+        return GpuFuture();
+    }
+    return GpuFuture(ring->timeline(), ring->push(submission));
+}
+
+size_t Device::get_queue_count(QueueKind kind) const noexcept
+{
+    return IMPL.get_queue_count(kind);
+}
+
+std::optional<QueueHandle>
+    Device::get_queue(QueueKind kind, size_t nth) const noexcept
+{
+    return IMPL.get_queue(kind, nth);
+}
+
+std::optional<QueueHandle>
+    Device::Impl::get_queue(QueueKind kind, size_t nth) const noexcept
+{
+    const auto &kind_slots = m_queues_by_kind[static_cast<size_t>(kind)];
+    if (nth >= kind_slots.size()) {
+        return std::nullopt;
+    }
+
+    const Queue &queue = m_queues[kind_slots[nth]];
+    VkQueueFlags flags = m_info->queue_families[queue.family_idx].queueFlags;
+    return QueueHandle{
+        kind,
+        queue.family_idx,
+        queue.idx,
+        family_rank(kind, flags) == 0u,
+        queue.users > 1};
 }
 
 DeviceType Device::get_device_type()
@@ -368,11 +664,49 @@ DeviceType Device::Impl::get_device_type()
     return DeviceType::UNKNOWN;
 }
 
-Device::Impl::Impl(VkPhysicalDevice &&device) noexcept
-    : m_phy_device(std::move(device))
+Device::Impl::Impl(
+    VkPhysicalDevice &&device,
+    std::shared_ptr<const PhysicalDeviceInfo> info,
+    std::pmr::memory_resource *host_backend) noexcept
+    : m_host_backend(host_backend), m_info(std::move(info)),
+      m_phy_device(std::move(device))
 {
     l.set_name(get_name());
-    m_alloc = std::make_unique<Allocator>();
+
+    // Keep driver host structures on the socket that drives the device
+    int numa_node = Allocator::any_numa_node;
+    if (numa::node_count() > 1) {
+        std::optional<int> device_node = numa::device_node(*m_info, l);
+        if (device_node) {
+            l.info("Host allocations bound to NUMA node {}", *device_node);
+            numa_node = *device_node;
+        }
+    }
+    create_allocator(numa_node);
+}
+
+void Device::Impl::create_allocator(int numa_node)
+{
+    Allocator::Options options = Allocator::default_options();
+    options.numa_node = numa_node;
+    options.backend = m_host_backend;
+    m_alloc = std::make_unique<Allocator>(options);
+    m_alloc->set_owner(get_name());
+}
+
+bool Device::Impl::set_numa_node(int node) noexcept
+try {
+    if (m_device != VK_NULL_HANDLE) {
+        l.warning("Cannot change NUMA node of a connected device");
+        return false;
+    }
+    // The allocator logs and stays unbound when it cannot bind the node
+    int requested = node < 0 ? Allocator::any_numa_node : node;
+    create_allocator(requested);
+    return m_alloc->get_numa_node() == requested;
+} catch (...) {
+    l.warning("NUMA node change failue: No host memory for allocator");
+    return false;
 }
 
 Device::Device(Impl &&o) noexcept
@@ -406,4 +740,49 @@ bool Device::connected() const
     return IMPL.connected();
 }
 
+bool Device::has_bindless() const noexcept
+{
+    return IMPL.get_bindless_table() != nullptr;
+}
+
+bool Device::supports(DeviceFeature feature) const noexcept
+{
+    return IMPL.supports(feature);
+}
+
+bool Device::has_feature(DeviceFeature feature) const noexcept
+{
+    return IMPL.has_feature(feature);
+}
+
+bool Device::has_extension(std::string_view name) const noexcept
+{
+    return IMPL.has_extension(name);
+}
+
+DescriptorCacheStats Device::get_descriptor_cache_stats() const noexcept
+{
+    return IMPL.get_descriptor_cache_stats();
+}
+
+SyncPoolStats Device::get_sync_pool_stats() const noexcept
+{
+    return IMPL.get_sync_pool_stats();
+}
+
+HostMemoryStats Device::get_host_memory_stats() const noexcept
+{
+    return IMPL.get_host_memory_stats();
+}
+
+int Device::get_numa_node() const noexcept
+{
+    return IMPL.get_numa_node();
+}
+
+bool Device::set_numa_node(int node) noexcept
+{
+    return IMPL.set_numa_node(node);
+}
+
 } // namespace pvk
@@ -0,0 +1,91 @@
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+#include <pvk/gpu_future.hh>
+
+#include "pvk/internal/timeline.hh"
+
+namespace pvk {
+
+GpuFuture::GpuFuture(
+    std::shared_ptr<Timeline> timeline, uint64_t value) noexcept
+    : m_timeline(std::move(timeline)), m_value(value)
+{
+}
+
+bool GpuFuture::ready() const noexcept
+{
+    return !m_timeline ||
+        (m_timeline->completed() >= m_value && !m_timeline->failed(m_value));
+}
+
+bool GpuFuture::failed() const noexcept
+{
+    return m_timeline && m_timeline->failed(m_value);
+}
+
+bool GpuFuture::wait(std::chrono::nanoseconds timeout) const noexcept
+{
+    return !m_timeline || m_timeline->wait(m_value, timeout);
+}
+
+void GpuFuture::then(Continuation continuation) const
+{
+    if (!m_timeline) {
+        continuation(true);
+        return;
+    }
+    m_timeline->then(m_value, std::move(continuation));
+}
+
+bool GpuFuture::wait_all(
+    std::span<const GpuFuture> futures,
+    std::chrono::nanoseconds timeout) noexcept
+{
+    using Clock = std::chrono::steady_clock;
+    auto deadline = timeout == forever ? Clock::time_point::max()
+                                       : Clock::now() + timeout;
+    for (const GpuFuture &future : futures) {
+        auto remaining = timeout;
+        if (timeout != forever) {
+            remaining = std::max(
+                std::chrono::nanoseconds(0),
+                std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    deadline - Clock::now()));
+        }
+        if (!future.wait(remaining)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::optional<size_t> GpuFuture::wait_any(
+    std::span<const GpuFuture> futures,
+    std::chrono::nanoseconds timeout) noexcept
+try {
+    std::vector<Timeline *> timelines;
+    std::vector<uint64_t> values;
+    timelines.reserve(futures.size());
+    values.reserve(futures.size());
+    for (size_t idx = 0; idx < futures.size(); idx++) {
+        if (!futures[idx].m_timeline) {
+            return idx;
+        }
+        timelines.emplace_back(futures[idx].m_timeline.get());
+        values.emplace_back(futures[idx].m_value);
+    }
+    return Timeline::wait_any(timelines, values, timeout);
+} catch (...) {
+    return std::nullopt;
+}
+
+} // namespace pvk
@@ -0,0 +1,895 @@
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <new>
+
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(PVK_ALLOCATOR_USE_MMAP)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#if defined(PVK_ALLOCATOR_USE_MMAP) && defined(__linux__) && \
+    defined(MAP_HUGETLB) && defined(MADV_HUGEPAGE)
+#define HOST_HEAP_HUGE_PAGES
+#endif
+
+#if defined(PVK_ALLOCATOR_USE_MMAP) && defined(__linux__)
+#include <sys/syscall.h>
+#if defined(SYS_mbind)
+#define HOST_HEAP_NUMA
+#endif
+#endif
+
+#include "pvk/internal/host_heap.hh"
+
+namespace {
+
+using namespace pvk::host_heap;
+
+constexpr size_t object_chunk_size = 64 * 1024;
+constexpr size_t persistent_chunk_size = 256 * 1024;
+constexpr size_t chunk_alignment = 4096;
+constexpr size_t magazine_capacity = 32;
+
+constexpr size_t huge_slab_size = 2 * 1024 * 1024;
+// Twice the slabs the registry can hold, 8 GiB of huge pages
+constexpr size_t slab_registry_capacity = 8192;
+
+constexpr size_t arena_chunk_size = 64 * 1024;
+constexpr size_t arena_chunk_header = 64;
+
+static_assert(class_size(class_count - 1) <= chunk_alignment);
+static_assert(object_chunk_size % class_size(class_count - 1) == 0);
+static_assert(persistent_chunk_size % class_size(class_count - 1) == 0);
+static_assert(arena_max_block + arena_chunk_header <= arena_chunk_size / 2);
+static_assert(huge_slab_size % persistent_chunk_size == 0);
+
+// Depot slot 0 is unbound, slot N + 1 belongs to NUMA node N
+constexpr size_t node_slots = max_numa_nodes + 1;
+
+constexpr size_t node_slot(int node)
+{
+    return node_bindable(node) ? static_cast<size_t>(node) + 1 : 0;
+}
+
+constexpr size_t depot_idx(Pool pool, int node)
+{
+    return static_cast<size_t>(pool) * node_slots + node_slot(node);
+}
+constexpr size_t depot_count = pool_count * node_slots;
+
+// Best effort, the range stays usable when binding fails
+[[maybe_unused]] static void bind_to_node(void *block, size_t size, int node)
+{
+#if defined(HOST_HEAP_NUMA)
+    if (!node_bindable(node)) {
+        return;
+    }
+    // MPOL_PREFERRED of linux/mempolicy.h: use the node while it has room
+    constexpr int mpol_preferred = 1;
+    unsigned long node_mask = 1ul << node;
+    syscall(
+        SYS_mbind,
+        block,
+        size,
+        mpol_preferred,
+        &node_mask,
+        sizeof(node_mask) * 8,
+        0);
+#else
+    (void)block;
+    (void)size;
+    (void)node;
+#endif
+}
+
+#if defined(PVK_ALLOCATOR_USE_MMAP)
+// Big blocks get their own mapping so they can grow with mremap
+constexpr size_t mmap_threshold = 128 * 1024;
+
+static size_t page_size()
+{
+    static const size_t size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    return size;
+}
+
+static size_t page_round(size_t size)
+{
+    return (size + page_size() - 1) / page_size() * page_size();
+}
+
+static bool is_page_backed(size_t alignment, size_t size)
+{
+    return size >= mmap_threshold && alignment <= page_size();
+}
+#endif
+
+static void *aligned_alloc_wrap(size_t alignment, size_t aligned_size)
+{
+#if defined(PVK_USE_WINDOWS_ALIGNED_ALLOC)
+    return _aligned_malloc(aligned_size, alignment);
+#else
+    return std::aligned_alloc(alignment, aligned_size);
+#endif
+}
+
+static void aligned_free_wrap(void *p)
+{
+#if defined(PVK_USE_WINDOWS_ALIGNED_ALLOC)
+    _aligned_free(p);
+#else
+    free(p);
+#endif
+}
+
+#if defined(HOST_HEAP_HUGE_PAGES)
+static bool transparent_huge_pages_enabled()
+{
+    std::FILE *file =
+        std::fopen("/sys/kernel/mm/transparent_hugepage/enabled", "r");
+    if (file == nullptr) {
+        return false;
+    }
+    std::array<char, 128> mode{};
+    size_t read = std::fread(mode.data(), 1, mode.size() - 1, file);
+    std::fclose(file);
+    return read != 0 && std::strstr(mode.data(), "[never]") == nullptr;
+}
+
+static void *map_huge_slab(int node)
+{
+    void *slab = mmap(
+        nullptr,
+        huge_slab_size,
+        PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB,
+        -1,
+        0);
+    if (slab != MAP_FAILED) {
+        bind_to_node(slab, huge_slab_size, node);
+        return slab;
+    }
+
+    static const bool transparent = transparent_huge_pages_enabled();
+    if (!transparent) {
+        return nullptr;
+    }
+
+    // Maps twice the slab size and trims it down to an aligned slab,
+    // the kernel only collapses naturally aligned ranges
+    void *mapping = mmap(
+        nullptr,
+        huge_slab_size * 2,
+        PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS,
+        -1,
+        0);
+    if (mapping == MAP_FAILED) {
+        return nullptr;
+    }
+
+    std::byte *base = static_cast<std::byte *>(mapping);
+    size_t addr = reinterpret_cast<size_t>(base);
+    size_t head = (huge_slab_size - addr % huge_slab_size) % huge_slab_size;
+    if (head != 0) {
+        munmap(base, head);
+    }
+    munmap(base + head + huge_slab_size, huge_slab_size - head);
+
+    slab = base + head;
+    if (madvise(slab, huge_slab_size, MADV_HUGEPAGE) != 0) {
+        munmap(slab, huge_slab_size);
+        return nullptr;
+    }
+    bind_to_node(slab, huge_slab_size, node);
+    return slab;
+}
+#endif
+
+// Slab chunk on regular pages, bound to the node before its first touch
+static void *map_chunk(size_t size, int node)
+{
+#if defined(HOST_HEAP_NUMA)
+    if (node_bindable(node)) {
+        void *chunk = mmap(
+            nullptr,
+            size,
+            PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS,
+            -1,
+            0);
+        if (chunk == MAP_FAILED) {
+            return nullptr;
+        }
+        bind_to_node(chunk, size, node);
+        return chunk;
+    }
+#else
+    (void)node;
+#endif
+    return aligned_alloc_wrap(chunk_alignment, size);
+}
+
+/*
+ * Base addresses of every huge page slab, slabs are aligned to their
+ * size and never unmapped. Insert only open addressing, so lookups
+ * from the telemetry of any thread take no lock.
+ */
+struct SlabRegistry
+{
+    // False once half full, the slab must not be used then
+    bool add(const void *slab) noexcept
+    {
+        if (m_count.fetch_add(1, std::memory_order_relaxed) >=
+            slab_registry_capacity / 2) {
+            return false;
+        }
+        size_t base = reinterpret_cast<size_t>(slab);
+        for (size_t idx = slot_of(base);;
+             idx = (idx + 1) % slab_registry_capacity) {
+            size_t empty = 0;
+            if (m_slots[idx].compare_exchange_strong(
+                    empty, base, std::memory_order_release)) {
+                return true;
+            }
+        }
+    }
+
+    bool contains(const void *block) const noexcept
+    {
+        size_t base = reinterpret_cast<size_t>(block) & ~(huge_slab_size - 1);
+        for (size_t idx = slot_of(base);;
+             idx = (idx + 1) % slab_registry_capacity) {
+            size_t slot = m_slots[idx].load(std::memory_order_acquire);
+            if (slot == base) {
+                return true;
+            }
+            if (slot == 0) {
+                return false;
+            }
+        }
+    }
+
+  private:
+    static size_t slot_of(size_t base) noexcept
+    {
+        return (base / huge_slab_size) * 0x9e3779b97f4a7c15 %
+            slab_registry_capacity;
+    }
+
+    std::atomic<size_t> m_count{0};
+    std::array<std::atomic<size_t>, slab_registry_capacity> m_slots{};
+};
+
+SlabRegistry &slab_registry() noexcept
+{
+    // Leaked like the slabs it indexes
+    static SlabRegistry *registry = new SlabRegistry();
+    return *registry;
+}
+
+/*
+ * Bump allocator handing out persistent chunks from huge page slabs.
+ * When no more huge pages can be mapped the chunks come from regular
+ * pages instead, so the pool keeps working and only loses the benefit.
+ * Mapping is not tried again after the first failure.
+ */
+struct HugeSlabs
+{
+    explicit HugeSlabs(int node) noexcept : m_node(node)
+    {
+    }
+
+    bool probe() noexcept
+    {
+        std::lock_guard guard(m_lock);
+        return m_slab != nullptr || next_slab();
+    }
+
+    void *take(size_t chunk_size) noexcept
+    {
+        std::lock_guard guard(m_lock);
+        if (m_slab == nullptr || m_offset + chunk_size > huge_slab_size) {
+            if (!next_slab()) {
+                void *chunk = map_chunk(chunk_size, m_node);
+                if (chunk != nullptr) {
+                    m_fallback_bytes.fetch_add(
+                        chunk_size, std::memory_order_relaxed);
+                }
+                return chunk;
+            }
+        }
+
+        void *chunk = m_slab + m_offset;
+        m_offset += chunk_size;
+        return chunk;
+    }
+
+    HugePageUsage usage() const noexcept
+    {
+        return HugePageUsage{
+            m_backed_bytes.load(std::memory_order_relaxed),
+            m_fallback_bytes.load(std::memory_order_relaxed)};
+    }
+
+  private:
+    bool next_slab() noexcept
+    {
+#if defined(HOST_HEAP_HUGE_PAGES)
+        if (m_exhausted) {
+            return false;
+        }
+        void *slab = map_huge_slab(m_node);
+        if (slab != nullptr && !slab_registry().add(slab)) {
+            munmap(slab, huge_slab_size);
+            slab = nullptr;
+        }
+        if (slab == nullptr) {
+            m_exhausted = true;
+            return false;
+        }
+        m_slab = static_cast<std::byte *>(slab);
+        m_offset = 0;
+        m_backed_bytes.fetch_add(huge_slab_size, std::memory_order_relaxed);
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    int m_node;
+    std::mutex m_lock;
+    std::byte *m_slab = nullptr;
+    size_t m_offset = 0;
+    bool m_exhausted = false;
+    std::atomic<size_t> m_backed_bytes{0};
+    std::atomic<size_t> m_fallback_bytes{0};
+};
+
+struct HugeSlabsSet
+{
+    HugeSlabsSet() noexcept
+    {
+        for (size_t slot = 0; slot < node_slots; slot++) {
+            slabs[slot] = new HugeSlabs(static_cast<int>(slot) - 1);
+        }
+    }
+
+    std::array<HugeSlabs *, node_slots> slabs;
+};
+
+HugeSlabs &huge_slabs(int node) noexcept
+{
+    // Intentionally leaked like the depots it feeds
+    static HugeSlabsSet *set = new HugeSlabsSet();
+    return *set->slabs[node_slot(node)];
+}
+
+struct FreeSlot
+{
+    FreeSlot *next;
+};
+
+/*
+ * Central store of free slots, one lock per size class.
+ * Chunks are never returned to the system: the drivers reuse
+ * the same sizes over and over, so slots are recycled instead.
+ */
+struct Depot
+{
+    Depot(size_t chunk_size, bool huge, int node) noexcept
+        : m_chunk_size(chunk_size), m_huge(huge), m_node(node)
+    {
+    }
+
+    struct alignas(64) Class
+    {
+        std::mutex lock;
+        FreeSlot *free_list = nullptr;
+    };
+
+    size_t take(size_t class_idx, void **out, size_t count) noexcept
+    {
+        Class &cls = m_classes[class_idx];
+        std::lock_guard guard(cls.lock);
+
+        size_t taken = 0;
+        while (taken < count) {
+            if (cls.free_list == nullptr && !grow(cls, class_idx)) {
+                break;
+            }
+            FreeSlot *slot = cls.free_list;
+            cls.free_list = slot->next;
+            out[taken++] = slot;
+        }
+        return taken;
+    }
+
+    void give(size_t class_idx, void *const *blocks, size_t count) noexcept
+    {
+        Class &cls = m_classes[class_idx];
+        std::lock_guard guard(cls.lock);
+
+        for (size_t block_idx = 0; block_idx < count; block_idx++) {
+            FreeSlot *slot = static_cast<FreeSlot *>(blocks[block_idx]);
+            slot->next = cls.free_list;
+            cls.free_list = slot;
+        }
+    }
+
+  private:
+    bool grow(Class &cls, size_t class_idx) noexcept
+    {
+        std::byte *chunk = static_cast<std::byte *>(
+            m_huge ? huge_slabs(m_node).take(m_chunk_size)
+                   : map_chunk(m_chunk_size, m_node));
+        if (chunk == nullptr) {
+            return false;
+        }
+
+        size_t slot_size = class_size(class_idx);
+        for (size_t offset = m_chunk_size; offset != 0;
+             offset -= slot_size) {
+            FreeSlot *slot =
+                reinterpret_cast<FreeSlot *>(chunk + offset - slot_size);
+            slot->next = cls.free_list;
+            cls.free_list = slot;
+        }
+        return true;
+    }
+
+    size_t m_chunk_size;
+    bool m_huge;
+    int m_node;
+    std::array<Class, class_count> m_classes;
+};
+
+struct DepotSet
+{
+    DepotSet() noexcept
+    {
+        for (Pool pool :
+             {Pool::OBJECT, Pool::PERSISTENT, Pool::HUGE_PERSISTENT}) {
+            size_t chunk_size = pool == Pool::OBJECT ? object_chunk_size
+                                                     : persistent_chunk_size;
+            bool huge = pool == Pool::HUGE_PERSISTENT;
+            for (size_t slot = 0; slot < node_slots; slot++) {
+                int node = static_cast<int>(slot) - 1;
+                depots[depot_idx(pool, node)] =
+                    new Depot(chunk_size, huge, node);
+            }
+        }
+    }
+
+    std::array<Depot *, depot_count> depots;
+};
+
+Depot &depot(size_t idx) noexcept
+{
+    // Intentionally leaked: thread exit may flush magazines at any time
+    static DepotSet *set = new DepotSet();
+    return *set->depots[idx];
+}
+
+/*
+ * Racks of a depot are allocated on its first use by the thread, so
+ * threads that never touch node bound pools do not carry their racks
+ */
+struct Magazine
+{
+    struct Rack
+    {
+        std::array<void *, magazine_capacity> slots;
+        size_t count = 0;
+    };
+    using Racks = std::array<Rack, class_count>;
+
+    Magazine() = default;
+    Magazine(const Magazine &) = delete;
+    Magazine &operator=(const Magazine &) = delete;
+
+    ~Magazine()
+    {
+        for (size_t idx = 0; idx < depot_count; idx++) {
+            if (m_racks[idx] == nullptr) {
+                continue;
+            }
+            for (size_t class_idx = 0; class_idx < class_count; class_idx++) {
+                Rack &rack = (*m_racks[idx])[class_idx];
+                depot(idx).give(class_idx, rack.slots.data(), rack.count);
+                rack.count = 0;
+            }
+        }
+    }
+
+    void *pop(size_t idx, size_t class_idx) noexcept
+    {
+        Racks *racks = racks_of(idx);
+        if (racks == nullptr) {
+            void *block = nullptr;
+            depot(idx).take(class_idx, &block, 1);
+            return block;
+        }
+
+        Rack &rack = (*racks)[class_idx];
+        if (rack.count == 0) {
+            rack.count = depot(idx).take(
+                class_idx, rack.slots.data(), magazine_capacity / 2);
+        }
+        if (rack.count == 0) {
+            return nullptr;
+        }
+        return rack.slots[--rack.count];
+    }
+
+    void push(size_t idx, size_t class_idx, void *block) noexcept
+    {
+        Racks *racks = racks_of(idx);
+        if (racks == nullptr) {
+            depot(idx).give(class_idx, &block, 1);
+            return;
+        }
+
+        Rack &rack = (*racks)[class_idx];
+        if (rack.count == magazine_capacity) {
+            size_t keep = magazine_capacity / 2;
+            depot(idx).give(
+                class_idx, rack.slots.data() + keep, rack.count - keep);
+            rack.count = keep;
+        }
+        rack.slots[rack.count++] = block;
+    }
+
+  private:
+    Racks *racks_of(size_t idx) noexcept
+    {
+        if (m_racks[idx] == nullptr) {
+            m_racks[idx].reset(new (std::nothrow) Racks());
+        }
+        return m_racks[idx].get();
+    }
+
+    std::array<std::unique_ptr<Racks>, depot_count> m_racks;
+};
+
+thread_local Magazine magazine;
+
+/*
+ * Chunks are aligned to their size, so the owning arena of any block
+ * is found by masking the block address down to the chunk header.
+ * The arena holds one reference for its owner thread and one per live
+ * block and is destroyed when the last reference goes away. Each chunk
+ * counts its own live blocks and rewinds once they are all freed, so a
+ * long lived block only pins the chunk it sits in.
+ */
+struct Arena
+{
+    struct Chunk
+    {
+        Arena *arena;
+        Chunk *next;
+        std::atomic<size_t> live;
+    };
+    static_assert(sizeof(Chunk) <= arena_chunk_header);
+
+    static Chunk *chunk_of(void *block) noexcept
+    {
+        size_t addr = reinterpret_cast<size_t>(block);
+        size_t chunk_addr = addr & ~(arena_chunk_size - 1);
+        return reinterpret_cast<Chunk *>(chunk_addr);
+    }
+
+    static Arena *from_block(void *block) noexcept
+    {
+        return chunk_of(block)->arena;
+    }
+
+    Arena() = default;
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+
+    ~Arena()
+    {
+        while (m_first != nullptr) {
+            Chunk *next = m_first->next;
+            m_first->~Chunk();
+            aligned_free_wrap(m_first);
+            m_first = next;
+        }
+    }
+
+    void *alloc(size_t alignment, size_t size) noexcept
+    {
+        if (m_current != nullptr &&
+            m_current->live.load(std::memory_order_acquire) == 0) {
+            m_offset = arena_chunk_header;
+        }
+
+        while (true) {
+            if (m_current != nullptr) {
+                size_t start =
+                    (m_offset + alignment - 1) / alignment * alignment;
+                if (start + size < arena_chunk_size) {
+                    m_offset = start + size;
+                    m_current->live.fetch_add(1, std::memory_order_relaxed);
+                    m_refs.fetch_add(1, std::memory_order_relaxed);
+                    return reinterpret_cast<std::byte *>(m_current) + start;
+                }
+            }
+
+            Chunk *next = next_free_chunk();
+            if (next == nullptr) {
+                next = new_chunk();
+            }
+            if (next == nullptr) {
+                return nullptr;
+            }
+            m_current = next;
+            m_offset = arena_chunk_header;
+        }
+    }
+
+    // Only the owner thread may move the bump offset
+    bool resize(std::byte *block, size_t old_size, size_t new_size) noexcept
+    {
+        std::byte *chunk_base = reinterpret_cast<std::byte *>(m_current);
+        size_t block_offset = static_cast<size_t>(block - chunk_base);
+        bool is_top = chunk_base != nullptr && block > chunk_base &&
+            block_offset + old_size == m_offset;
+
+        if (!is_top) {
+            return new_size <= old_size;
+        }
+
+        if (block_offset + new_size >= arena_chunk_size) {
+            return false;
+        }
+        m_offset = block_offset + new_size;
+        return true;
+    }
+
+    static void free(void *block) noexcept
+    {
+        Chunk *chunk = chunk_of(block);
+        Arena *arena = chunk->arena;
+        chunk->live.fetch_sub(1, std::memory_order_acq_rel);
+        release(arena);
+    }
+
+    static void release(Arena *arena) noexcept
+    {
+        if (arena->m_refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete arena;
+        }
+    }
+
+  private:
+    // Next chunk without live blocks after the current one, wrapping
+    // around the list
+    Chunk *next_free_chunk() noexcept
+    {
+        if (m_current == nullptr) {
+            return m_first;
+        }
+        Chunk *chunk = m_current->next != nullptr ? m_current->next : m_first;
+        for (; chunk != m_current;
+             chunk = chunk->next != nullptr ? chunk->next : m_first) {
+            if (chunk->live.load(std::memory_order_acquire) == 0) {
+                return chunk;
+            }
+        }
+        return nullptr;
+    }
+
+    Chunk *new_chunk() noexcept
+    {
+        void *memory = aligned_alloc_wrap(arena_chunk_size, arena_chunk_size);
+        if (memory == nullptr) {
+            return nullptr;
+        }
+        Chunk *chunk = new (memory) Chunk{this, nullptr, {0}};
+
+        if (m_last != nullptr) {
+            m_last->next = chunk;
+        } else {
+            m_first = chunk;
+        }
+        m_last = chunk;
+        return chunk;
+    }
+
+    std::atomic<size_t> m_refs{1};
+    Chunk *m_first = nullptr;
+    Chunk *m_last = nullptr;
+    Chunk *m_current = nullptr;
+    size_t m_offset = arena_chunk_header;
+};
+
+struct ArenaOwner
+{
+    ArenaOwner() = default;
+    ArenaOwner(const ArenaOwner &) = delete;
+    ArenaOwner &operator=(const ArenaOwner &) = delete;
+
+    ~ArenaOwner()
+    {
+        if (arena != nullptr) {
+            Arena::release(arena);
+        }
+    }
+
+    Arena *get() noexcept
+    {
+        if (arena == nullptr) {
+            arena = new (std::nothrow) Arena();
+        }
+        return arena;
+    }
+
+    Arena *peek() const noexcept
+    {
+        return arena;
+    }
+
+  private:
+    Arena *arena = nullptr;
+};
+
+thread_local ArenaOwner arena_owner;
+
+} // namespace
+
+namespace pvk::host_heap {
+
+bool numa_binding_supported() noexcept
+{
+#if defined(HOST_HEAP_NUMA)
+    return true;
+#else
+    return false;
+#endif
+}
+
+void *class_alloc(Pool pool, int node, size_t class_idx) noexcept
+{
+    return magazine.pop(depot_idx(pool, node), class_idx);
+}
+
+void class_free(Pool pool, int node, size_t class_idx, void *block) noexcept
+{
+    magazine.push(depot_idx(pool, node), class_idx, block);
+}
+
+bool huge_pages_available() noexcept
+{
+    static const bool available = huge_slabs(any_node).probe();
+    return available;
+}
+
+bool in_huge_slab(const void *block) noexcept
+{
+    return slab_registry().contains(block);
+}
+
+HugePageUsage huge_page_usage() noexcept
+{
+    HugePageUsage output{0, 0};
+    for (size_t slot = 0; slot < node_slots; slot++) {
+        HugePageUsage node_usage =
+            huge_slabs(static_cast<int>(slot) - 1).usage();
+        output.backed_bytes += node_usage.backed_bytes;
+        output.fallback_bytes += node_usage.fallback_bytes;
+    }
+    return output;
+}
+
+void *arena_alloc(size_t alignment, size_t size) noexcept
+{
+    Arena *arena = arena_owner.get();
+    if (arena == nullptr) {
+        return nullptr;
+    }
+    return arena->alloc(alignment, size == 0 ? 1 : size);
+}
+
+bool arena_resize(
+    void *block, size_t alignment, size_t old_size, size_t new_size) noexcept
+{
+    if (reinterpret_cast<size_t>(block) % alignment != 0) {
+        return false;
+    }
+
+    new_size = new_size == 0 ? 1 : new_size;
+    old_size = old_size == 0 ? 1 : old_size;
+
+    Arena *arena = Arena::from_block(block);
+    if (arena != arena_owner.peek()) {
+        return new_size <= old_size;
+    }
+    return arena->resize(static_cast<std::byte *>(block), old_size, new_size);
+}
+
+void arena_free(void *block) noexcept
+{
+    Arena::free(block);
+}
+
+void *large_alloc(size_t alignment, size_t size, int node) noexcept
+{
+#if defined(PVK_ALLOCATOR_USE_MMAP)
+    if (is_page_backed(alignment, size)) {
+        void *block = mmap(
+            nullptr,
+            page_round(size),
+            PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS,
+            -1,
+            0);
+        if (block == MAP_FAILED) {
+            return nullptr;
+        }
+        bind_to_node(block, page_round(size), node);
+        return block;
+    }
+#endif
+    (void)node;
+    return aligned_alloc_wrap(alignment, size);
+}
+
+void *large_resize(
+    void *block, size_t alignment, size_t old_size, size_t new_size) noexcept
+{
+#if defined(PVK_ALLOCATOR_USE_MMAP)
+    if (!is_page_backed(alignment, old_size) ||
+        !is_page_backed(alignment, new_size)) {
+        return nullptr;
+    }
+
+    if (page_round(old_size) == page_round(new_size)) {
+        return block;
+    }
+
+#if defined(__linux__)
+    void *moved = mremap(
+        block, page_round(old_size), page_round(new_size), MREMAP_MAYMOVE);
+    return moved == MAP_FAILED ? nullptr : moved;
+#else
+    if (new_size < old_size) {
+        std::byte *tail =
+            static_cast<std::byte *>(block) + page_round(new_size);
+        munmap(tail, page_round(old_size) - page_round(new_size));
+        return block;
+    }
+    return nullptr;
+#endif
+
+#else
+    (void)block;
+    (void)alignment;
+    (void)old_size;
+    (void)new_size;
+    return nullptr;
+#endif
+}
+
+void large_free(void *block, size_t alignment, size_t size) noexcept
+{
+#if defined(PVK_ALLOCATOR_USE_MMAP)
+    if (is_page_backed(alignment, size)) {
+        munmap(block, page_round(size));
+        return;
+    }
+#else
+    (void)alignment;
+    (void)size;
+#endif
+    aligned_free_wrap(block);
+}
+
+} // namespace pvk::host_heap
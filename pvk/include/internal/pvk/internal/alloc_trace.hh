@@ -0,0 +1,94 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+namespace pvk {
+
+/*
+ * Binary trace of the driver host allocations:
+ * a FileHeader followed by Records in per thread batches.
+ * Batches of different threads interleave, order them by timestamp.
+ */
+struct AllocTrace
+{
+    static constexpr std::array<char, 8> magic{
+        'P', 'V', 'K', 'T', 'R', 'A', 'C', 'E'};
+    static constexpr uint32_t version = 1;
+
+    struct FileHeader
+    {
+        std::array<char, 8> magic;
+        uint32_t version;
+        uint32_t record_size;
+    };
+
+    enum class Event : uint8_t
+    {
+        ALLOC,
+        FREE,
+        REALLOC,
+    };
+
+    struct Record
+    {
+        uint64_t timestamp_ns;
+        uint64_t block;
+        uint64_t original;
+        uint64_t size;
+        uint32_t thread;
+        Event event;
+        uint8_t scope;
+        uint8_t align_log2;
+        uint8_t reserved;
+    };
+    static_assert(sizeof(Record) == 40);
+
+    static std::shared_ptr<AllocTrace> open(const std::string &path) noexcept;
+
+    // Trace named by the PVK_ALLOCATION_TRACE environment variable
+    static std::shared_ptr<AllocTrace> from_environment() noexcept;
+
+    /*
+     * Appends to the calling thread's buffer without locking.
+     * Full buffers, buffers of a thread switching to another trace and
+     * buffers of exiting threads are written out under the file lock.
+     * A zero timestamp_ns stamps the record with now().
+     */
+    static void record(
+        const std::shared_ptr<AllocTrace> &trace,
+        Event event,
+        const void *block,
+        const void *original,
+        size_t size,
+        size_t alignment,
+        uint8_t scope,
+        uint64_t timestamp_ns = 0) noexcept;
+
+    // Steady clock nanoseconds, the time base of the records
+    static uint64_t now() noexcept;
+
+    // Writes out the calling thread's buffer
+    static void flush_thread() noexcept;
+
+    // Appends a batch of records under the file lock
+    void write(const Record *records, size_t count) noexcept;
+
+    AllocTrace(const AllocTrace &) = delete;
+    AllocTrace &operator=(const AllocTrace &) = delete;
+    ~AllocTrace() noexcept;
+
+  private:
+    AllocTrace() noexcept = default;
+
+    std::mutex m_lock;
+    std::FILE *m_file = nullptr;
+};
+
+} // namespace pvk
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+#include <pvk/logger.hh>
+
+#include "pvk/internal/physical_device_info.hh"
+#include "pvk/internal/timeline.hh"
+#include "pvk/internal/vk_api.hh"
+
+namespace pvk {
+
+/*
+ * Device wide descriptor arrays for kernels that index their resources
+ * instead of binding a set per dispatch. One update after bind set holds
+ * an array per kind of resource, each added resource keeps a stable index
+ * in its array until removed. The set is bound once per command buffer,
+ * dispatches only push the indices they use:
+ *
+ *   layout(set = 0, binding = 0) buffer Buffers { uint data[]; } buffers[];
+ *   layout(set = 0, binding = 1) uniform texture2D sampled_images[];
+ *   layout(set = 0, binding = 2, r32f) uniform image2D storage_images[];
+ *   layout(set = 0, binding = 3) uniform sampler samplers[];
+ *   layout(push_constant) uniform Indices { uint indices[32]; };
+ *
+ * Needs the Vulkan 1.2 descriptor indexing features, connect enables them
+ * when the device reports them.
+ */
+class BindlessTable
+{
+  public:
+    // Also the binding of the array in the set
+    enum class Kind : uint32_t
+    {
+        STORAGE_BUFFER,
+        SAMPLED_IMAGE,
+        STORAGE_IMAGE,
+        SAMPLER,
+    };
+    static constexpr size_t nb_kinds = 4;
+    static constexpr uint32_t invalid_index = UINT32_MAX;
+
+    static bool supported(const PhysicalDeviceInfo &info);
+    // Sets the features the table relies on
+    static void enable(VkPhysicalDeviceVulkan12Features &features);
+
+    // nullptr on failure
+    static std::unique_ptr<BindlessTable> create(
+        VkDevice device,
+        const PhysicalDeviceInfo &info,
+        const VkAllocationCallbacks *callbacks) noexcept;
+    // The device must be idle
+    ~BindlessTable();
+
+    BindlessTable(const BindlessTable &) = delete;
+    BindlessTable &operator=(const BindlessTable &) = delete;
+
+    // Index of the resource in its array, invalid_index when full or on
+    // failure. Written right away, even while the set is in use
+    uint32_t add_buffer(
+        VkBuffer buffer,
+        VkDeviceSize offset = 0,
+        VkDeviceSize range = VK_WHOLE_SIZE) noexcept;
+    uint32_t add_sampled_image(VkImageView view, VkImageLayout layout) noexcept;
+    uint32_t add_storage_image(VkImageView view, VkImageLayout layout) noexcept;
+    uint32_t add_sampler(VkSampler sampler) noexcept;
+
+    // Submissions up to value may still read the slot, it is handed out
+    // again once value completes
+    void remove(
+        Kind kind,
+        uint32_t index,
+        std::shared_ptr<Timeline> timeline,
+        uint64_t value) noexcept;
+
+    VkDescriptorSetLayout set_layout() const noexcept
+    {
+        return m_set_layout;
+    }
+
+    // Set 0 is the table, every stage sees push_constant_size() bytes
+    VkPipelineLayout pipeline_layout() const noexcept
+    {
+        return m_pipeline_layout;
+    }
+
+    uint32_t push_constant_size() const noexcept
+    {
+        return m_push_constant_size;
+    }
+
+    // Once per command buffer and bind point
+    void bind(VkCommandBuffer buffer, VkPipelineBindPoint bind_point) noexcept;
+    // Before each dispatch, offset in indices
+    void push(
+        VkCommandBuffer buffer,
+        std::span<const uint32_t> indices,
+        uint32_t offset = 0) noexcept;
+
+    uint32_t capacity(Kind kind) const noexcept;
+    uint32_t in_use(Kind kind) const noexcept;
+
+  private:
+    struct Removed
+    {
+        uint32_t index;
+        std::shared_ptr<Timeline> timeline;
+        uint64_t value;
+    };
+
+    struct Slots
+    {
+        mutable std::mutex lock;
+        uint32_t capacity = 0;
+        // Never handed out from there on
+        uint32_t next = 0;
+        std::vector<uint32_t> free;
+        std::vector<Removed> removed;
+        // Per slot, handed out and not removed since
+        std::vector<bool> live;
+        uint32_t in_use = 0;
+    };
+
+    BindlessTable(VkDevice device, const VkAllocationCallbacks *callbacks);
+
+    uint32_t acquire(Kind kind) noexcept;
+    uint32_t write(
+        Kind kind,
+        const VkDescriptorBufferInfo *buffer_info,
+        const VkDescriptorImageInfo *image_info) noexcept;
+
+    VkDevice m_device;
+    const VkAllocationCallbacks *m_callbacks;
+    VkDescriptorSetLayout m_set_layout = VK_NULL_HANDLE;
+    VkPipelineLayout m_pipeline_layout = VK_NULL_HANDLE;
+    VkDescriptorPool m_pool = VK_NULL_HANDLE;
+    VkDescriptorSet m_set = VK_NULL_HANDLE;
+    uint32_t m_push_constant_size = 0;
+
+    std::array<Slots, nb_kinds> m_slots;
+    // Writes to the set are externally synchronized
+    std::mutex m_update_lock;
+
+    Logger l;
+};
+
+} // namespace pvk
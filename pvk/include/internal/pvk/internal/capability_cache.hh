@@ -0,0 +1,117 @@
+#pragma once
+
+#include <array>
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+#include <pvk/logger.hh>
+
+#include "pvk/internal/layer_utils.hh"
+#include "pvk/internal/physical_device_info.hh"
+#include "pvk/internal/vk_api.hh"
+
+namespace pvk {
+
+/*
+ * On-disk copy of the layer and extension enumeration done at startup.
+ *
+ * The instance part is keyed by the loader version, the instance layer
+ * list (names and versions) and the extensions of the implementation,
+ * all of which are still queried live: a match skips the per layer
+ * extension enumeration. A device entry is keyed by the vendor, device
+ * and driver versions plus pipelineCacheUUID, and replaces the device
+ * layer, extension and format enumeration. A new entry replaces the one
+ * of the same vendor and device ids, a changed instance key drops the
+ * whole file.
+ *
+ * The file is a FileHeader followed by a flat stream of fixed size
+ * records and length prefixed names, checked by an FNV-1a sum.
+ */
+class CapabilityCache
+{
+  public:
+    static constexpr std::array<char, 8> magic{
+        'P', 'V', 'K', 'C', 'A', 'P', 'S', '\0'};
+    static constexpr uint32_t version = 1;
+
+    struct FileHeader
+    {
+        std::array<char, 8> magic;
+        uint32_t version;
+        uint32_t device_count;
+        uint64_t payload_size;
+        uint64_t payload_checksum;
+    };
+
+    struct InstanceKey
+    {
+        uint32_t loader_version = 0;
+        std::vector<VkLayerProperties> layers;
+        std::vector<VkExtensionProperties> extensions;
+    };
+
+    struct DeviceKey
+    {
+        uint32_t vendor_id;
+        uint32_t device_id;
+        uint32_t driver_version;
+        uint32_t api_version;
+        std::array<uint8_t, VK_UUID_SIZE> pipeline_cache_uuid;
+
+        static DeviceKey of(const VkPhysicalDeviceProperties &properties);
+        bool operator==(const DeviceKey &) const = default;
+    };
+
+    // Empty cache on missing, corrupted or foreign files
+    static CapabilityCache load(const std::string &path, Logger &l);
+
+    // Writes through a temporary file renamed over path, so concurrent
+    // processes never read a partial file
+    bool store(Logger &l) const;
+
+    bool dirty() const
+    {
+        return m_dirty;
+    }
+
+    // Per layer extensions when key matches the cached instance part
+    std::optional<std::vector<LayerExtensions>>
+        find_instance(const InstanceKey &key) const;
+
+    // Replaces the instance part and drops every device entry
+    void put_instance(InstanceKey key, std::vector<LayerExtensions> layers);
+
+    // Fills extensions, formats and layers of info, false on a miss
+    bool restore(PhysicalDeviceInfo &info) const;
+    // Replaces the entry of the same vendor and device ids
+    void remember(const PhysicalDeviceInfo &info);
+
+  private:
+    struct DeviceEntry
+    {
+        DeviceKey key;
+        std::vector<VkExtensionProperties> extensions;
+        std::vector<VkFormatProperties> formats;
+        std::vector<LayerExtensions> layers;
+    };
+
+    bool parse(const std::vector<std::byte> &payload, uint32_t device_count);
+    std::vector<std::byte> serialize() const;
+
+    std::string m_path;
+    bool m_dirty = false;
+    InstanceKey m_instance;
+    std::vector<LayerExtensions> m_instance_layers;
+    std::vector<DeviceEntry> m_devices;
+};
+
+// Instance version of the loader, 1.0 when vkEnumerateInstanceVersion
+// is not available
+uint32_t loader_version();
+
+} // namespace pvk
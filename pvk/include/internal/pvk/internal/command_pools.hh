@@ -0,0 +1,117 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <span>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+#include <pvk/logger.hh>
+
+#include "pvk/internal/timeline.hh"
+#include "pvk/internal/vk_api.hh"
+
+namespace pvk {
+
+/*
+ * Command buffers of a device, recorded without contention: every thread
+ * records into VkCommandPools of its own, one per queue family. Buffers
+ * are never freed one by one. At the end of a frame the pools recorded
+ * into are retired with the timeline value of the submission using them,
+ * and the owning thread takes each back with a single vkResetCommandPool
+ * once that value completes. The pools of threads that exited are
+ * destroyed by retire once their submissions complete.
+ */
+class CommandPools
+{
+  public:
+    CommandPools(
+        VkDevice device,
+        size_t nb_families,
+        const VkAllocationCallbacks *callbacks);
+    // The device must be idle
+    ~CommandPools();
+
+    CommandPools(const CommandPools &) = delete;
+    CommandPools &operator=(const CommandPools &) = delete;
+
+    // Begun one time submit buffers from the pools of the calling thread,
+    // VK_NULL_HANDLE on failure
+    VkCommandBuffer primary(uint32_t family_idx) noexcept;
+    VkCommandBuffer secondary(
+        uint32_t family_idx,
+        const VkCommandBufferInheritanceInfo &inheritance,
+        VkCommandBufferUsageFlags usage = 0) noexcept;
+
+    // Secondaries recorded and ended on any threads, executed in order
+    static void stitch(
+        VkCommandBuffer primary,
+        std::span<const VkCommandBuffer> secondaries) noexcept;
+
+    // End of frame, every thread must be done recording for the family:
+    // the pools used since the previous retire wait for value
+    void retire(
+        uint32_t family_idx,
+        std::shared_ptr<Timeline> timeline,
+        uint64_t value) noexcept;
+
+    size_t pool_count() const noexcept
+    {
+        return m_nb_pools.load(std::memory_order_relaxed);
+    }
+
+  private:
+    struct Pool
+    {
+        VkCommandPool pool = VK_NULL_HANDLE;
+        std::vector<VkCommandBuffer> primaries;
+        std::vector<VkCommandBuffer> secondaries;
+        size_t used_primaries = 0;
+        size_t used_secondaries = 0;
+        // Set when retired
+        std::shared_ptr<Timeline> timeline;
+        uint64_t value = 0;
+    };
+
+    // Vulkan calls on the pools only come from the owning thread, the
+    // lock covers the hand over of retire
+    struct ThreadPools
+    {
+        // Expires when the owning thread exits
+        std::weak_ptr<const bool> owner;
+        std::mutex lock;
+        std::vector<std::unique_ptr<Pool>> recording;
+        std::vector<std::vector<std::unique_ptr<Pool>>> in_flight;
+        std::vector<std::vector<std::unique_ptr<Pool>>> free;
+    };
+
+    ThreadPools &thread_pools();
+    // Destroys what exited threads left once it is no longer in flight
+    void reclaim_exited() noexcept;
+    Pool *recording_pool(ThreadPools &pools, uint32_t family_idx);
+    std::unique_ptr<Pool> create_pool(uint32_t family_idx);
+    void destroy_pool(Pool &pool) noexcept;
+    VkCommandBuffer next_buffer(
+        Pool &pool, VkCommandBufferLevel level) noexcept;
+
+    VkDevice m_device;
+    size_t m_nb_families;
+    const VkAllocationCallbacks *m_callbacks;
+    // Key of the per thread lookup cache, never reused
+    uint64_t m_id;
+    std::atomic<size_t> m_nb_pools{0};
+
+    std::shared_mutex m_threads_lock;
+    std::unordered_map<std::thread::id, std::unique_ptr<ThreadPools>>
+        m_threads;
+
+    Logger l;
+};
+
+} // namespace pvk
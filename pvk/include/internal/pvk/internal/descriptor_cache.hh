@@ -0,0 +1,200 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+#include <pvk/descriptor_cache_stats.hh>
+#include <pvk/logger.hh>
+
+#include "pvk/internal/timeline.hh"
+#include "pvk/internal/vk_api.hh"
+
+namespace pvk {
+
+// One descriptor of a set, arrays take a write per element. The infos
+// not used by the type stay zeroed, they are part of the content
+struct DescriptorWrite
+{
+    uint32_t binding = 0;
+    uint32_t array_element = 0;
+    VkDescriptorType type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    VkDescriptorBufferInfo buffer{};
+    VkDescriptorImageInfo image{};
+    VkBufferView texel_view = VK_NULL_HANDLE;
+};
+
+/*
+ * Descriptor objects of a device, created once per description. Layouts
+ * and samplers are deduplicated device wide and live as long as the
+ * cache. Sets come from a growable list of VkDescriptorPools per layout
+ * and are cached by the content of their writes, so binding the same
+ * resources again costs a lookup instead of an allocation and an update.
+ * Like CommandPools, the pools handed out from are retired at the end of
+ * an epoch with a timeline value. Once it completes a pool is reset whole
+ * the next time its layout needs room, dropping its cached sets.
+ */
+class DescriptorCache
+{
+  public:
+    DescriptorCache(VkDevice device, const VkAllocationCallbacks *callbacks);
+    // The device must be idle
+    ~DescriptorCache();
+
+    DescriptorCache(const DescriptorCache &) = delete;
+    DescriptorCache &operator=(const DescriptorCache &) = delete;
+
+    // Owned by the cache, VK_NULL_HANDLE on failure. The order of the
+    // bindings does not matter
+    VkDescriptorSetLayout layout(
+        std::span<const VkDescriptorSetLayoutBinding> bindings,
+        VkDescriptorSetLayoutCreateFlags flags = 0) noexcept;
+    // Extension chains are not supported
+    VkSampler sampler(const VkSamplerCreateInfo &create_info) noexcept;
+
+    // Set of a layout from layout() holding the writes, VK_NULL_HANDLE on
+    // failure. The same writes in the same order give back the same set
+    // until its pool is recycled
+    VkDescriptorSet set(
+        VkDescriptorSetLayout layout,
+        std::span<const DescriptorWrite> writes) noexcept;
+
+    // Uncached set of a layout from layout(), written by the caller. Same
+    // lifetime as the cached ones
+    VkDescriptorSet allocate(VkDescriptorSetLayout layout) noexcept;
+
+    // End of epoch, no set may be handed out meanwhile: the pools used
+    // since the previous retire wait for value
+    void retire(std::shared_ptr<Timeline> timeline, uint64_t value) noexcept;
+
+    // Once a resource referenced by cached sets is destroyed, its handle
+    // may come back for another one
+    void forget_sets() noexcept;
+
+    DescriptorCacheStats stats() const noexcept;
+
+  private:
+    struct Binding
+    {
+        uint32_t binding;
+        VkDescriptorType type;
+        uint32_t count;
+        VkShaderStageFlags stages;
+        std::vector<VkSampler> immutable_samplers;
+
+        bool operator==(const Binding &) const = default;
+    };
+
+    struct LayoutKey
+    {
+        VkDescriptorSetLayoutCreateFlags flags;
+        // Sorted by binding
+        std::vector<Binding> bindings;
+
+        bool operator==(const LayoutKey &) const = default;
+    };
+
+    struct LayoutKeyHash
+    {
+        size_t operator()(const LayoutKey &key) const noexcept;
+    };
+
+    struct SamplerHash
+    {
+        size_t operator()(const VkSamplerCreateInfo &info) const noexcept;
+    };
+
+    struct SamplerEqual
+    {
+        bool operator()(
+            const VkSamplerCreateInfo &lhs,
+            const VkSamplerCreateInfo &rhs) const noexcept;
+    };
+
+    struct Epoch
+    {
+        std::shared_ptr<Timeline> timeline;
+        uint64_t value;
+    };
+
+    struct Pool
+    {
+        VkDescriptorPool pool = VK_NULL_HANDLE;
+        uint32_t capacity = 0;
+        uint32_t used = 0;
+        // Cache keys of the sets allocated from the pool
+        std::vector<uint64_t> set_keys;
+        // Handed out from since the previous retire
+        bool touched = false;
+        // One per timeline the pool was retired with
+        std::vector<Epoch> epochs;
+    };
+
+    struct CachedSet
+    {
+        VkDescriptorSet set;
+        Pool *pool;
+        std::vector<DescriptorWrite> writes;
+    };
+
+    // Sets of one layout, each pool sized for a number of them
+    struct LayoutPools
+    {
+        std::mutex lock;
+        std::vector<VkDescriptorPoolSize> set_sizes;
+        VkDescriptorPoolCreateFlags flags = 0;
+        // The last one allocates
+        std::vector<std::unique_ptr<Pool>> pools;
+        // Keyed by the hash of the writes, colliding sets are uncached
+        std::unordered_map<uint64_t, CachedSet> sets;
+        uint32_t next_capacity;
+    };
+
+    struct Counters
+    {
+        std::atomic<uint64_t> hits{0};
+        std::atomic<uint64_t> misses{0};
+    };
+
+    LayoutPools *layout_pools(VkDescriptorSetLayout layout);
+    VkDescriptorSet allocate(
+        LayoutPools &pools, VkDescriptorSetLayout layout, Pool *&pool);
+    Pool *next_pool(LayoutPools &pools);
+    void recycle(LayoutPools &pools, Pool &pool) noexcept;
+
+    VkDevice m_device;
+    const VkAllocationCallbacks *m_callbacks;
+
+    // Covers both maps, the pools of a layout have their own lock
+    mutable std::shared_mutex m_layouts_lock;
+    std::unordered_map<LayoutKey, VkDescriptorSetLayout, LayoutKeyHash>
+        m_layouts;
+    std::unordered_map<VkDescriptorSetLayout, std::unique_ptr<LayoutPools>>
+        m_layout_pools;
+
+    mutable std::shared_mutex m_samplers_lock;
+    std::unordered_map<
+        VkSamplerCreateInfo,
+        VkSampler,
+        SamplerHash,
+        SamplerEqual>
+        m_samplers;
+
+    Counters m_layout_counters;
+    Counters m_sampler_counters;
+    Counters m_set_counters;
+    std::atomic<uint64_t> m_nb_pools{0};
+    std::atomic<uint64_t> m_pool_resets{0};
+    std::atomic<uint64_t> m_reset_sets{0};
+
+    Logger l;
+};
+
+} // namespace pvk
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <memory>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+#include <pvk/logger.hh>
+
+#include "pvk/internal/descriptor_cache.hh"
+#include "pvk/internal/vk_api.hh"
+
+namespace pvk {
+
+// VK_KHR_push_descriptor, not part of the bundled loader
+inline constexpr std::string_view push_descriptor_extension =
+    "VK_KHR_push_descriptor";
+inline constexpr VkDescriptorSetLayoutCreateFlags push_descriptor_layout_bit =
+    0x00000001;
+inline constexpr VkDescriptorUpdateTemplateType push_descriptors_template =
+    static_cast<VkDescriptorUpdateTemplateType>(1);
+// Guaranteed value of maxPushDescriptors
+inline constexpr uint32_t min_max_push_descriptors = 32;
+
+using PFN_PushDescriptorSetWithTemplate = void(VKAPI_PTR *)(
+    VkCommandBuffer,
+    VkDescriptorUpdateTemplate,
+    VkPipelineLayout,
+    uint32_t,
+    const void *);
+
+/*
+ * Parameters of a pipeline written in one call from a packed host struct.
+ * The update template maps every binding to an offset and a stride in the
+ * struct: VkDescriptorBufferInfo for buffers, VkDescriptorImageInfo for
+ * images and samplers, VkBufferView for texel buffers. With push
+ * descriptors the struct goes straight into the command buffer, otherwise
+ * a set from the DescriptorCache pools is written and bound. Update
+ * templates are core from Vulkan 1.1: on 1.0 the struct is unpacked into
+ * writes looked up in the DescriptorCache sets instead.
+ */
+class DescriptorTemplate
+{
+  public:
+    struct Entry
+    {
+        uint32_t binding;
+        VkDescriptorType type;
+        uint32_t count;
+        size_t offset;
+        size_t stride;
+    };
+
+    // Push descriptors are used when push is loaded and the bindings fit
+    // the guaranteed limit, update templates from api_version 1.1. nullptr
+    // on failure
+    static std::unique_ptr<DescriptorTemplate> create(
+        VkDevice device,
+        uint32_t api_version,
+        std::span<const Entry> entries,
+        VkPipelineBindPoint bind_point,
+        DescriptorCache &cache,
+        PFN_PushDescriptorSetWithTemplate push,
+        const VkAllocationCallbacks *callbacks) noexcept;
+    ~DescriptorTemplate();
+
+    DescriptorTemplate(const DescriptorTemplate &) = delete;
+    DescriptorTemplate &operator=(const DescriptorTemplate &) = delete;
+
+    // Set 0 holds the parameters, the layout is owned by the cache
+    VkDescriptorSetLayout set_layout() const noexcept
+    {
+        return m_set_layout;
+    }
+
+    VkPipelineLayout pipeline_layout() const noexcept
+    {
+        return m_pipeline_layout;
+    }
+
+    bool pushes() const noexcept
+    {
+        return m_push != nullptr;
+    }
+
+    // For the dispatches recorded next. Sets written meanwhile live until
+    // the cache pools are retired past the submission
+    bool bind(VkCommandBuffer buffer, const void *parameters) noexcept;
+
+  private:
+    // Without update templates
+    VkDescriptorSet cached_set(const void *parameters);
+
+    DescriptorTemplate(
+        VkDevice device,
+        VkPipelineBindPoint bind_point,
+        DescriptorCache &cache,
+        const VkAllocationCallbacks *callbacks);
+
+    VkDevice m_device;
+    VkPipelineBindPoint m_bind_point;
+    DescriptorCache &m_cache;
+    const VkAllocationCallbacks *m_callbacks;
+    PFN_PushDescriptorSetWithTemplate m_push = nullptr;
+    VkDescriptorSetLayout m_set_layout = VK_NULL_HANDLE;
+    VkPipelineLayout m_pipeline_layout = VK_NULL_HANDLE;
+    VkDescriptorUpdateTemplate m_template = VK_NULL_HANDLE;
+    // Kept to unpack the struct when there is no template
+    std::vector<Entry> m_entries;
+
+    Logger l;
+};
+
+} // namespace pvk
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <string_view>
+
+#include <cstdint>
+
+#include <pvk/device_features.hh>
+
+#include "pvk/internal/vk_api.hh"
+
+namespace pvk {
+
+// Feature structures chained to vkCreateDevice, named like the ones of
+// PhysicalDeviceInfo so feature_flag reads both
+struct DeviceFeatureChain
+{
+    DeviceFeatureChain();
+
+    DeviceFeatureChain(const DeviceFeatureChain &) = delete;
+    DeviceFeatureChain &operator=(const DeviceFeatureChain &) = delete;
+
+    // Only the structures api_version defines are chained
+    void link(VkDeviceCreateInfo &create_info, uint32_t api_version);
+
+    VkPhysicalDeviceFeatures features{};
+    VkPhysicalDeviceVulkan11Features features_11{};
+    VkPhysicalDeviceVulkan12Features features_12{};
+    VkPhysicalDeviceVulkan13Features features_13{};
+};
+
+std::string_view feature_name(DeviceFeature feature);
+
+// Field of the feature in a PhysicalDeviceInfo or a DeviceFeatureChain
+template <typename Features>
+auto &feature_flag(Features &f, DeviceFeature feature)
+{
+    switch (feature) {
+    case DeviceFeature::SHADER_FLOAT64:
+        return f.features.shaderFloat64;
+    case DeviceFeature::SHADER_INT64:
+        return f.features.shaderInt64;
+    case DeviceFeature::SHADER_INT16:
+        return f.features.shaderInt16;
+    case DeviceFeature::STORAGE_BUFFER_16BIT:
+        return f.features_11.storageBuffer16BitAccess;
+    case DeviceFeature::UNIFORM_BUFFER_16BIT:
+        return f.features_11.uniformAndStorageBuffer16BitAccess;
+    case DeviceFeature::PUSH_CONSTANT_16BIT:
+        return f.features_11.storagePushConstant16;
+    case DeviceFeature::SHADER_FLOAT16:
+        return f.features_12.shaderFloat16;
+    case DeviceFeature::SHADER_INT8:
+        return f.features_12.shaderInt8;
+    case DeviceFeature::STORAGE_BUFFER_8BIT:
+        return f.features_12.storageBuffer8BitAccess;
+    case DeviceFeature::UNIFORM_BUFFER_8BIT:
+        return f.features_12.uniformAndStorageBuffer8BitAccess;
+    case DeviceFeature::PUSH_CONSTANT_8BIT:
+        return f.features_12.storagePushConstant8;
+    case DeviceFeature::SHADER_BUFFER_INT64_ATOMICS:
+        return f.features_12.shaderBufferInt64Atomics;
+    case DeviceFeature::SUBGROUP_EXTENDED_TYPES:
+        return f.features_12.shaderSubgroupExtendedTypes;
+    case DeviceFeature::SCALAR_BLOCK_LAYOUT:
+        return f.features_12.scalarBlockLayout;
+    case DeviceFeature::BUFFER_DEVICE_ADDRESS:
+        return f.features_12.bufferDeviceAddress;
+    case DeviceFeature::TIMELINE_SEMAPHORE:
+        return f.features_12.timelineSemaphore;
+    case DeviceFeature::VULKAN_MEMORY_MODEL:
+        return f.features_12.vulkanMemoryModel;
+    case DeviceFeature::HOST_QUERY_RESET:
+        return f.features_12.hostQueryReset;
+    case DeviceFeature::SYNCHRONIZATION2:
+        return f.features_13.synchronization2;
+    case DeviceFeature::SUBGROUP_SIZE_CONTROL:
+        return f.features_13.subgroupSizeControl;
+    case DeviceFeature::COMPUTE_FULL_SUBGROUPS:
+        return f.features_13.computeFullSubgroups;
+    case DeviceFeature::INTEGER_DOT_PRODUCT:
+        return f.features_13.shaderIntegerDotProduct;
+    case DeviceFeature::ZERO_INITIALIZE_WORKGROUP_MEMORY:
+        return f.features_13.shaderZeroInitializeWorkgroupMemory;
+    case DeviceFeature::MAINTENANCE4:
+        return f.features_13.maintenance4;
+    }
+    // Out of range values read as the first feature
+    return f.features.shaderFloat64;
+}
+
+} // namespace pvk
@@ -1,20 +1,38 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <bitset>
 #include <memory>
+#include <memory_resource>
 #include <new>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <utility>
-#include <variant>
 #include <vector>
 
 #include <cstddef>
 #include <cstdint>
 
+#include <pvk/descriptor_cache_stats.hh>
 #include <pvk/device.hh>
+#include <pvk/device_features.hh>
+#include <pvk/gpu_future.hh>
 #include <pvk/instance.hh>
 #include <pvk/logger.hh>
+#include <pvk/queue_plan.hh>
+#include <pvk/sync_pool_stats.hh>
 
+#include "pvk/internal/bindless_table.hh"
+#include "pvk/internal/command_pools.hh"
+#include "pvk/internal/descriptor_cache.hh"
+#include "pvk/internal/descriptor_template.hh"
 #include "pvk/internal/layer_utils.hh"
+#include "pvk/internal/physical_device_info.hh"
+#include "pvk/internal/submit_ring.hh"
+#include "pvk/internal/sync_pools.hh"
+#include "pvk/internal/timeline.hh"
 #include "pvk/internal/vk_allocator.hh"
 #include "pvk/internal/vk_api.hh"
 
@@ -24,7 +42,12 @@ namespace pvk {
 
 struct alignas(Device) Device::Impl
 {
-    bool connect();
+    bool connect(std::pmr::memory_resource *scratch);
+    bool connect(const QueuePlan &plan, std::pmr::memory_resource *scratch);
+    bool connect(
+        const QueuePlan &plan,
+        const DeviceFeatureRequest &request,
+        std::pmr::memory_resource *scratch);
     bool connected() const
     {
         return m_device != VK_NULL_HANDLE;
@@ -32,7 +55,10 @@ struct alignas(Device) Device::Impl
 
     void disconnect();
 
-    Impl(VkPhysicalDevice &&device) noexcept;
+    Impl(
+        VkPhysicalDevice &&device,
+        std::shared_ptr<const PhysicalDeviceInfo> info,
+        std::pmr::memory_resource *host_backend) noexcept;
 
     ~Impl()
     {
@@ -48,10 +74,19 @@ struct alignas(Device) Device::Impl
     }
 
     Impl(Impl &&o) noexcept
-        : l(std::move(o.l)), m_alloc(std::move(o.m_alloc)),
-          m_device_meta(std::move(o.m_device_meta)),
+        : l(std::move(o.l)), m_host_backend(o.m_host_backend),
+          m_alloc(std::move(o.m_alloc)), m_info(std::move(o.m_info)),
           m_phy_device(o.m_phy_device), m_device(o.m_device),
-          m_queues(std::move(o.m_queues))
+          m_queues(std::move(o.m_queues)),
+          m_queues_by_kind(std::move(o.m_queues_by_kind)),
+          m_submit_rings(std::move(o.m_submit_rings)),
+          m_command_pools(std::move(o.m_command_pools)),
+          m_descriptor_cache(std::move(o.m_descriptor_cache)),
+          m_bindless_table(std::move(o.m_bindless_table)),
+          m_push_descriptor(o.m_push_descriptor),
+          m_sync_pools(std::move(o.m_sync_pools)),
+          m_enabled_features(o.m_enabled_features),
+          m_enabled_extensions(std::move(o.m_enabled_extensions))
     {
         if (this == &o) {
             return;
@@ -79,65 +114,147 @@ struct alignas(Device) Device::Impl
         return true;
     }
 
-    VkPhysicalDeviceProperties get_device_props()
+    // Snapshot taken by the instance, shared by every Device of it
+    const PhysicalDeviceInfo &get_info() const
     {
-        if (std::holds_alternative<VkPhysicalDeviceProperties>(m_device_meta)) {
-            return std::get<VkPhysicalDeviceProperties>(m_device_meta);
-        }
-        VkPhysicalDeviceProperties new_props{};
-        vkGetPhysicalDeviceProperties(m_phy_device, &new_props);
-        m_device_meta = new_props;
-        return new_props;
+        return *m_info;
     }
 
-    VkPhysicalDeviceFeatures get_device_features()
+    const VkPhysicalDeviceProperties &get_device_props() const
     {
-        if (std::holds_alternative<VkPhysicalDeviceFeatures>(m_device_meta)) {
-            return std::get<VkPhysicalDeviceFeatures>(m_device_meta);
-        }
-        VkPhysicalDeviceFeatures new_features{};
-        vkGetPhysicalDeviceFeatures(m_phy_device, &new_features);
-        m_device_meta = new_features;
-        return new_features;
+        return m_info->properties;
     }
 
-    std::vector<VkQueueFamilyProperties> get_queue_families()
+    const VkPhysicalDeviceFeatures &get_device_features() const
     {
-        if (std::holds_alternative<std::vector<VkQueueFamilyProperties>>(
-                m_device_meta)) {
-            return std::get<std::vector<VkQueueFamilyProperties>>(
-                m_device_meta);
-        }
+        return m_info->features;
+    }
 
-        uint32_t nb_queues = 0;
-        vkGetPhysicalDeviceQueueFamilyProperties(
-            m_phy_device, &nb_queues, nullptr);
+    // Reported by the device, whether enabled or not
+    bool supports(DeviceFeature feature) const;
+
+    // Granted by connect, nothing before
+    bool has_feature(DeviceFeature feature) const noexcept
+    {
+        size_t feature_idx = static_cast<size_t>(feature);
+        return feature_idx < device_feature_count &&
+            m_enabled_features[feature_idx];
+    }
 
-        std::vector<VkQueueFamilyProperties> queues_props(nb_queues);
-        vkGetPhysicalDeviceQueueFamilyProperties(
-            m_phy_device, &nb_queues, queues_props.data());
+    bool has_extension(std::string_view name) const noexcept
+    {
+        return std::ranges::find(m_enabled_extensions, name) !=
+            std::end(m_enabled_extensions);
+    }
 
-        m_device_meta = queues_props;
-        return queues_props;
+    const std::vector<VkQueueFamilyProperties> &get_queue_families() const
+    {
+        return m_info->queue_families;
     }
 
-    std::string get_name()
+    std::string get_name() const
     {
         return get_device_props().deviceName;
     }
 
     DeviceType get_device_type();
 
+    HostMemoryStats get_host_memory_stats() const noexcept
+    {
+        return m_alloc->snapshot();
+    }
+
+    int get_numa_node() const noexcept
+    {
+        return m_alloc->get_numa_node();
+    }
+
+    bool set_numa_node(int node) noexcept;
+
+    size_t get_queue_count(QueueKind kind) const noexcept
+    {
+        return m_queues_by_kind[static_cast<size_t>(kind)].size();
+    }
+
+    std::optional<QueueHandle>
+        get_queue(QueueKind kind, size_t nth) const noexcept;
+
+    // Sole submission path of the nth queue of a kind, nullptr when the
+    // device has no such queue
+    SubmitRing *get_submit_ring(QueueKind kind, size_t nth) const noexcept
+    {
+        const auto &kind_slots = m_queues_by_kind[static_cast<size_t>(kind)];
+        if (nth >= kind_slots.size()) {
+            return nullptr;
+        }
+        return m_submit_rings[kind_slots[nth]].get();
+    }
+
+    // VK_NULL_HANDLE until connected
+    VkDevice get_logical_device() const noexcept
+    {
+        return m_device;
+    }
+
+    const VkAllocationCallbacks *get_callbacks() const noexcept
+    {
+        return m_alloc->get_callbacks();
+    }
+
+    // Recording side of every queue, nullptr until connected
+    CommandPools *get_command_pools() const noexcept
+    {
+        return m_command_pools.get();
+    }
+
+    // Layouts, samplers and sets, nullptr until connected
+    DescriptorCache *get_descriptor_cache() const noexcept
+    {
+        return m_descriptor_cache.get();
+    }
+
+    DescriptorCacheStats get_descriptor_cache_stats() const noexcept
+    {
+        return m_descriptor_cache ? m_descriptor_cache->stats()
+                                  : DescriptorCacheStats{};
+    }
+
+    // nullptr until connected or without descriptor indexing
+    BindlessTable *get_bindless_table() const noexcept
+    {
+        return m_bindless_table.get();
+    }
+
+    // nullptr without VK_KHR_push_descriptor
+    PFN_PushDescriptorSetWithTemplate get_push_descriptor() const noexcept
+    {
+        return m_push_descriptor;
+    }
+
+    // Fences, semaphores and events, nullptr until connected
+    SyncPools *get_sync_pools() const noexcept
+    {
+        return m_sync_pools.get();
+    }
+
+    SyncPoolStats get_sync_pool_stats() const noexcept
+    {
+        return m_sync_pools ? m_sync_pools->stats() : SyncPoolStats{};
+    }
+
+    // Ready future when the device has no such queue
+    GpuFuture submit(
+        QueueKind kind, size_t nth, const Submission &submission) noexcept;
+    GpuFuture end_frame(QueueKind kind, size_t nth) noexcept;
+
   private:
+    void create_allocator(int numa_node);
+
     Logger l;
+    std::pmr::memory_resource *m_host_backend = nullptr;
     std::unique_ptr<Allocator> m_alloc = nullptr;
 
-    std::variant<
-        std::monostate,
-        VkPhysicalDeviceProperties,
-        VkPhysicalDeviceFeatures,
-        std::vector<VkQueueFamilyProperties>>
-        m_device_meta;
+    std::shared_ptr<const PhysicalDeviceInfo> m_info;
 
     VkPhysicalDevice m_phy_device = VK_NULL_HANDLE;
     VkDevice m_device = VK_NULL_HANDLE;
@@ -149,9 +266,22 @@ struct alignas(Device) Device::Impl
         VkQueue queue;
         FamilyIndex family_idx;
         QueueIndex idx;
+        // Plan requests served by this queue
+        uint32_t users;
     };
 
     std::vector<Queue> m_queues;
+    // Per kind, index in m_queues of each planned queue
+    std::array<std::vector<size_t>, queue_kind_count> m_queues_by_kind;
+    // Parallel to m_queues, shared queues share their ring
+    std::vector<std::unique_ptr<SubmitRing>> m_submit_rings;
+    std::unique_ptr<CommandPools> m_command_pools;
+    std::unique_ptr<DescriptorCache> m_descriptor_cache;
+    std::unique_ptr<BindlessTable> m_bindless_table;
+    PFN_PushDescriptorSetWithTemplate m_push_descriptor = nullptr;
+    std::unique_ptr<SyncPools> m_sync_pools;
+    std::bitset<device_feature_count> m_enabled_features;
+    std::vector<std::string> m_enabled_extensions;
 };
 
 } // namespace pvk
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cstddef>
+
+namespace pvk::host_heap {
+
+/*
+ * Small blocks are served from power of two size classes.
+ * Every slot of a class is aligned to the class size, so a request
+ * fits a class when both its size and its alignment fit the slot.
+ */
+constexpr size_t min_class_shift = 4;
+constexpr size_t max_class_shift = 12;
+constexpr size_t class_count = max_class_shift - min_class_shift + 1;
+constexpr size_t no_class = class_count;
+
+constexpr size_t class_size(size_t class_idx)
+{
+    return size_t(1) << (class_idx + min_class_shift);
+}
+
+constexpr size_t class_of(size_t size, size_t alignment)
+{
+    size_t needed = size < alignment ? alignment : size;
+    for (size_t class_idx = 0; class_idx < class_count; class_idx++) {
+        if (class_size(class_idx) >= needed) {
+            return class_idx;
+        }
+    }
+    return no_class;
+}
+
+/*
+ * Slabs are kept apart by expected lifetime so that long lived
+ * device/instance objects do not pin chunks full of short lived ones.
+ * HUGE_PERSISTENT is the persistent pool carved out of 2 MiB huge page
+ * slabs, use it only after huge_pages_available() returned true.
+ */
+enum class Pool
+{
+    OBJECT,
+    PERSISTENT,
+    HUGE_PERSISTENT,
+};
+constexpr size_t pool_count = 3;
+
+/*
+ * Slabs and page backed blocks of a pool can be bound to a NUMA node.
+ * Every node gets its own depots, nodes past max_numa_nodes and
+ * any_node share the unbound ones. Binding needs PVK_ALLOCATOR_USE_MMAP
+ * on Linux and is a preference: the kernel falls back to other nodes
+ * when the preferred one is out of memory.
+ */
+constexpr int any_node = -1;
+constexpr int max_numa_nodes = 8;
+
+constexpr bool node_bindable(int node)
+{
+    return node >= 0 && node < max_numa_nodes;
+}
+
+bool numa_binding_supported() noexcept;
+
+// Thread local magazine backed by a process wide depot
+void *class_alloc(Pool pool, int node, size_t class_idx) noexcept;
+void class_free(Pool pool, int node, size_t class_idx, void *block) noexcept;
+
+/*
+ * Maps the first huge page slab on the first call: explicit huge pages
+ * (MAP_HUGETLB) are tried first, then transparent ones (MADV_HUGEPAGE).
+ * False when neither works, or without PVK_ALLOCATOR_USE_MMAP on Linux.
+ */
+bool huge_pages_available() noexcept;
+
+// Process wide, slabs are never unmapped
+struct HugePageUsage
+{
+    size_t backed_bytes;
+    // Chunks of HUGE_PERSISTENT that fell back to regular pages
+    // because the system ran out of huge pages
+    size_t fallback_bytes;
+};
+HugePageUsage huge_page_usage() noexcept;
+
+// Whether the block sits on huge pages rather than a fallback chunk
+bool in_huge_slab(const void *block) noexcept;
+
+/*
+ * Per thread bump arena for command scoped blocks, never node bound:
+ * first touch already places it on the node of the calling thread.
+ * Each chunk of the arena rewinds once every block it handed out is
+ * freed, freeing a block from another thread is allowed.
+ */
+constexpr size_t arena_max_block = 8 * 1024;
+
+constexpr bool arena_fits(size_t size, size_t alignment)
+{
+    return size <= arena_max_block && alignment <= arena_max_block;
+}
+
+void *arena_alloc(size_t alignment, size_t size) noexcept;
+void arena_free(void *block) noexcept;
+
+// Shrinks any arena block, grows the topmost block of the caller's arena
+bool arena_resize(
+    void *block, size_t alignment, size_t old_size, size_t new_size) noexcept;
+
+/*
+ * Direct system allocation for blocks that do not fit any class.
+ * With PVK_ALLOCATOR_USE_MMAP big blocks are page backed and
+ * large_resize remaps them, otherwise it returns nullptr and the
+ * caller falls back to allocate and copy.
+ */
+void *large_alloc(size_t alignment, size_t size, int node) noexcept;
+void *large_resize(
+    void *block, size_t alignment, size_t old_size, size_t new_size) noexcept;
+void large_free(void *block, size_t alignment, size_t size) noexcept;
+
+} // namespace pvk::host_heap
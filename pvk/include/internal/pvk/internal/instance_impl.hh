@@ -1,27 +1,38 @@
 #pragma once
 
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <memory_resource>
 #include <new>
 #include <optional>
+#include <span>
+#include <string>
 #include <string_view>
 #include <vector>
 
 #include <pvk/device.hh>
 #include <pvk/instance.hh>
+#include <pvk/instance_options.hh>
 #include <pvk/logger.hh>
 
 #if (PVK_USE_EXT_DEBUG_UTILS)
 #include <pvk/extensions/debug_utils_context.hh>
 #endif
 
+#include "pvk/internal/capability_cache.hh"
+#include "pvk/internal/physical_device_info.hh"
 #include "pvk/internal/vk_allocator.hh"
 #include "pvk/internal/vk_api.hh"
 
 namespace pvk {
 struct alignas(Instance) Instance::Impl
 {
-    static std::optional<Instance> create();
+    static std::optional<Instance> create(
+        const InstanceOptions &options,
+        std::pmr::memory_resource *scratch,
+        std::pmr::memory_resource *host_backend);
 
     Impl(Impl &&other) noexcept;
     Impl &operator=(Impl &&other) = delete;
@@ -40,16 +51,40 @@ struct alignas(Instance) Instance::Impl
         return *std::launder(reinterpret_cast<Impl const *>(inst.impl));
     }
 
-    bool load_devices();
+    bool load_devices(
+        std::pmr::memory_resource *scratch, CapabilityCache *cache);
 
     size_t get_device_count() const noexcept;
     std::optional<Device> get_device(size_t device_idx) const noexcept;
+    std::vector<DeviceConnectResult> connect_devices(
+        std::span<Device> devices, size_t max_threads);
+
+    HostMemoryStats get_host_memory_stats() const noexcept
+    {
+        return m_allocator->snapshot();
+    }
+
+    uint32_t get_api_version() const noexcept
+    {
+        return m_api_version;
+    }
+
+    bool has_extension(std::string_view name) const noexcept
+    {
+        return std::ranges::find(m_enabled_extensions, name) !=
+            std::end(m_enabled_extensions);
+    }
 
   private:
     std::shared_ptr<Allocator> m_allocator = nullptr;
+    std::pmr::memory_resource *m_host_backend = nullptr;
     VkInstance m_vk_instance = VK_NULL_HANDLE;
     Logger l;
+    uint32_t m_api_version = VK_API_VERSION_1_0;
+    std::vector<std::string> m_enabled_extensions;
     std::vector<VkPhysicalDevice> m_devices;
+    // Queried once per physical device, parallel to m_devices
+    std::vector<std::shared_ptr<const PhysicalDeviceInfo>> m_device_infos;
 
 #if (PVK_USE_EXT_DEBUG_UTILS)
     static void debug_utils_log_cb(
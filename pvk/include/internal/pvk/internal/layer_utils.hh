@@ -1,39 +1,78 @@
 #pragma once
 
+#include <memory_resource>
 #include <string>
 #include <string_view>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include <pvk/logger.hh>
 
 #include "pvk/internal/vk_api.hh"
 
-using LayerExtMap =
-    std::unordered_map<std::string, std::unordered_set<std::string>>;
+/*
+ * Layer and extension names are setup temporaries: every container
+ * draws from the memory resource passed to the query that built it
+ */
+using NameSet = std::pmr::unordered_set<std::pmr::string>;
+using LayerExtMap = std::pmr::unordered_map<std::pmr::string, NameSet>;
 
 namespace pvk {
 
+// Persistent form of a LayerExtMap entry, outlives the setup scratch
+struct LayerExtensions
+{
+    std::string layer;
+    std::vector<std::string> extensions;
+};
+
+std::vector<LayerExtensions> to_layer_list(const LayerExtMap &layer_extensions);
+LayerExtMap to_layer_map(
+    const std::vector<LayerExtensions> &layer_list,
+    std::pmr::memory_resource *scratch = std::pmr::get_default_resource());
+
 void dump_extensions_per_layer(const LayerExtMap &lay_exts, const std::string_view label, Logger &l);
-std::unordered_set<std::string> get_instance_layers(Logger &l);
-std::unordered_set<std::string>
-    get_device_layers(VkPhysicalDevice device, Logger &l);
+std::pmr::vector<VkLayerProperties> get_instance_layer_properties(
+    Logger &l,
+    std::pmr::memory_resource *scratch = std::pmr::get_default_resource());
+NameSet layer_names(
+    const std::pmr::vector<VkLayerProperties> &layers,
+    Logger &l,
+    std::pmr::memory_resource *scratch = std::pmr::get_default_resource());
 
-std::unordered_set<std::string>
-    get_instance_layer_extensions(const char *layer_name, Logger &l);
+NameSet get_instance_layers(
+    Logger &l,
+    std::pmr::memory_resource *scratch = std::pmr::get_default_resource());
+NameSet get_device_layers(
+    VkPhysicalDevice device,
+    Logger &l,
+    std::pmr::memory_resource *scratch = std::pmr::get_default_resource());
+
+std::pmr::vector<VkExtensionProperties> get_instance_extension_properties(
+    const char *layer_name,
+    Logger &l,
+    std::pmr::memory_resource *scratch = std::pmr::get_default_resource());
+NameSet get_instance_layer_extensions(
+    const char *layer_name,
+    Logger &l,
+    std::pmr::memory_resource *scratch = std::pmr::get_default_resource());
 
 LayerExtMap get_instance_layers_extensions(
-    const std::unordered_set<std::string> &layer_names, Logger &l
-);
+    const NameSet &layer_names,
+    Logger &l,
+    std::pmr::memory_resource *scratch = std::pmr::get_default_resource());
 
-std::unordered_set<std::string> get_device_layer_extensions(
-    const VkPhysicalDevice &device, const char *layer_name, Logger &l
-);
+NameSet get_device_layer_extensions(
+    const VkPhysicalDevice &device,
+    const char *layer_name,
+    Logger &l,
+    std::pmr::memory_resource *scratch = std::pmr::get_default_resource());
 
 LayerExtMap get_device_layers_extensions(
     const VkPhysicalDevice &device,
-    const std::unordered_set<std::string> &layer_names,
-    Logger &l
-);
+    const NameSet &layer_names,
+    Logger &l,
+    std::pmr::memory_resource *scratch = std::pmr::get_default_resource());
 
 } // namespace pvk
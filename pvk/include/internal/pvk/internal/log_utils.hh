@@ -26,7 +26,8 @@ inline std::vector<Segment> split_ln(const std::string_view &data)
         return {{0, data.size()}};
     }
 
-    static std::vector<Segment> output;
+    // Loggers of different devices run on concurrent connect workers
+    thread_local std::vector<Segment> output;
     output.clear();
     if (output.capacity() < linebreaks) {
         output.reserve(linebreaks);
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <optional>
+
+#include <cstddef>
+#include <cstdint>
+
+#include <pvk/logger.hh>
+
+#include "pvk/internal/physical_device_info.hh"
+
+namespace pvk::numa {
+
+// Number of NUMA nodes of the host, 1 when it cannot be discovered
+size_t node_count() noexcept;
+
+// Node a PCI function is attached to, as reported by sysfs
+std::optional<int> pci_node(
+    uint32_t domain, uint32_t bus, uint32_t device, uint32_t function) noexcept;
+
+// Node of a physical device found through its PCI address
+std::optional<int>
+    device_node(const PhysicalDeviceInfo &info, Logger &l) noexcept;
+
+} // namespace pvk::numa
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+#include <pvk/logger.hh>
+
+#include "pvk/internal/layer_utils.hh"
+#include "pvk/internal/vk_api.hh"
+
+namespace pvk {
+
+class CapabilityCache;
+
+/*
+ * Everything pvk asks a physical device about, queried once when the
+ * instance enumerates it. Devices share the snapshot, so accessors
+ * never go back to the driver.
+ */
+struct PhysicalDeviceInfo
+{
+    struct PciAddress
+    {
+        uint32_t domain;
+        uint32_t bus;
+        uint32_t device;
+        uint32_t function;
+    };
+
+    // Extensions, formats and layers come from cache when it knows the
+    // device and driver, the cache learns them otherwise
+    static PhysicalDeviceInfo query(
+        VkPhysicalDevice device,
+        uint32_t instance_api_version,
+        Logger &l,
+        CapabilityCache *cache = nullptr);
+
+    // Lower of the instance and device versions
+    uint32_t api_version = 0;
+
+    VkPhysicalDeviceProperties properties{};
+    VkPhysicalDeviceFeatures features{};
+    // Zeroed when api_version is too old to report them
+    VkPhysicalDeviceVulkan11Features features_11{};
+    VkPhysicalDeviceVulkan12Features features_12{};
+    VkPhysicalDeviceVulkan13Features features_13{};
+    // Zeroed before 1.2, the descriptor indexing limits live there
+    VkPhysicalDeviceVulkan12Properties properties_12{};
+    VkPhysicalDeviceMemoryProperties memory{};
+    std::vector<VkQueueFamilyProperties> queue_families;
+    // Sorted by name
+    std::vector<VkExtensionProperties> extensions;
+    // Indexed by VkFormat, core 1.0 formats only
+    std::vector<VkFormatProperties> formats;
+    // Device layers with the extensions each of them adds
+    std::vector<LayerExtensions> layers;
+    // From VK_EXT_pci_bus_info, needs vkGetPhysicalDeviceProperties2 and
+    // so Vulkan 1.1
+    std::optional<PciAddress> pci_address;
+
+    const VkPhysicalDeviceLimits &limits() const
+    {
+        return properties.limits;
+    }
+
+    bool has_extension(std::string_view name) const;
+
+    // Zeroed properties for formats outside the core 1.0 range
+    const VkFormatProperties &format_properties(VkFormat format) const;
+};
+
+} // namespace pvk
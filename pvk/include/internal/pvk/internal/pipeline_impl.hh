@@ -0,0 +1,146 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+#include <pvk/device.hh>
+#include <pvk/gpu_future.hh>
+#include <pvk/host_memory_stats.hh>
+#include <pvk/logger.hh>
+#include <pvk/pipeline.hh>
+#include <pvk/pipeline_parameters.hh>
+#include <pvk/specialization.hh>
+
+#include "pvk/internal/descriptor_template.hh"
+#include "pvk/internal/vk_allocator.hh"
+#include "pvk/internal/vk_api.hh"
+
+namespace pvk {
+
+struct Pipeline::Impl
+{
+    Impl(std::shared_ptr<Device> device_context) noexcept
+        : m_device_context(device_context)
+    {
+        l.set_name("Pipeline");
+        m_allocator = std::make_unique<Allocator>();
+        m_allocator->set_owner("Pipeline");
+    }
+
+    Impl(Impl &&o)
+        : m_shaders(std::move(o.m_shaders)),
+          m_entry_point(std::move(o.m_entry_point)),
+          m_device_context(std::move(o.m_device_context)),
+          m_layout(o.m_layout), m_pipeline(o.m_pipeline),
+          m_allocator(std::move(o.m_allocator)),
+          m_parameters(std::move(o.m_parameters)),
+          m_last_dispatches(std::move(o.m_last_dispatches)),
+          m_variants(std::move(o.m_variants)), l(std::move(o.l))
+    {
+        o.m_shaders.clear();
+        o.m_layout = VK_NULL_HANDLE;
+        o.m_pipeline = VK_NULL_HANDLE;
+    }
+
+    ~Impl() noexcept;
+
+    // Replaces the shader, the pipeline is built from it by configure
+    bool set_compute_shader(
+        std::span<const uint32_t> spirv, std::string_view entry_point) noexcept;
+
+    // Builds the pipeline of the shader with the constants, over the
+    // layout of the parameters. A previous variant is destroyed once the
+    // dispatches recorded with it complete, none may run meanwhile
+    bool configure(std::span<const SpecializationConstant> constants) noexcept;
+
+    bool configured() const noexcept
+    {
+        return m_pipeline != VK_NULL_HANDLE;
+    }
+
+    HostMemoryStats get_host_memory_stats() const noexcept
+    {
+        return m_allocator->snapshot();
+    }
+
+    bool set_parameters(std::span<const PipelineParameter> parameters) noexcept;
+
+    bool pushes_parameters() const noexcept
+    {
+        return m_parameters && m_parameters->pushes();
+    }
+
+    // Parameters of the dispatches recorded next, read from the packed
+    // host struct set_parameters described
+    bool bind_parameters(
+        VkCommandBuffer buffer, const void *parameters) noexcept;
+
+    // Pipeline of the dispatches recorded next
+    bool bind(VkCommandBuffer buffer) noexcept;
+
+    std::optional<GpuFuture> dispatch(
+        const void *parameters,
+        uint32_t groups_x,
+        uint32_t groups_y,
+        uint32_t groups_z,
+        size_t nth_queue) noexcept;
+
+    static Impl &cast_from(std::byte *data)
+    {
+        return *std::launder(reinterpret_cast<Impl *>(data));
+    }
+
+    static Impl const &cast_from(std::byte const *data)
+    {
+        return *std::launder(reinterpret_cast<Impl const *>(data));
+    }
+
+    VkPipelineLayout get_layout() const noexcept
+    {
+        return m_parameters ? m_parameters->pipeline_layout() : m_layout;
+    }
+
+    static bool assert_size()
+    {
+        static_assert(sizeof(Impl) < Pipeline::impl_size);
+        return true;
+    }
+
+  private:
+    // A replaced pipeline and the latest dispatch per queue that used it
+    struct Variant
+    {
+        VkPipeline pipeline;
+        std::vector<GpuFuture> dispatches;
+    };
+
+    void destroy_shaders() noexcept;
+    // Destroys the variants no dispatch uses anymore, all with wait
+    void release_variants(bool wait) noexcept;
+
+    std::vector<VkShaderModule> m_shaders;
+    std::string m_entry_point;
+    std::shared_ptr<Device> m_device_context;
+    // Parameterless pipelines only, the parameters have their own
+    VkPipelineLayout m_layout = VK_NULL_HANDLE;
+    VkPipeline m_pipeline = VK_NULL_HANDLE;
+    std::unique_ptr<Allocator> m_allocator = nullptr;
+    std::unique_ptr<DescriptorTemplate> m_parameters;
+    // Indexed by queue, the latest dispatch of the current pipeline
+    std::mutex m_dispatch_lock;
+    std::vector<GpuFuture> m_last_dispatches;
+    std::vector<Variant> m_variants;
+    Logger l;
+};
+
+} // namespace pvk
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <array>
+#include <optional>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+#include <pvk/logger.hh>
+#include <pvk/queue_plan.hh>
+
+#include "pvk/internal/vk_api.hh"
+
+namespace pvk {
+
+struct QueueSelection
+{
+    struct Slot
+    {
+        uint32_t family_idx;
+        uint32_t queue_idx;
+        float priority;
+        // Number of requests served by this queue
+        uint32_t users;
+    };
+
+    // Queues to create, queue_idx runs from 0 within each family
+    std::vector<Slot> slots;
+    // Per kind, slot of each request in plan order
+    std::array<std::vector<size_t>, queue_kind_count> by_kind;
+};
+
+const char *queue_kind_name(QueueKind kind);
+
+// Rank of a family for a kind, 0 being the most specialised,
+// nullopt when the family cannot serve the kind
+std::optional<uint32_t> family_rank(QueueKind kind, VkQueueFlags flags);
+
+// nullopt when some request has no family able to serve it
+std::optional<QueueSelection> select_queues(
+    const QueuePlan &plan,
+    const std::vector<VkQueueFamilyProperties> &families,
+    Logger &l);
+
+// One queue of every kind some family supports
+QueuePlan default_queue_plan(
+    const std::vector<VkQueueFamilyProperties> &families);
+
+} // namespace pvk
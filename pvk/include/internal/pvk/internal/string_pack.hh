@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <cstddef>
 #include <iterator>
+#include <memory_resource>
 #include <optional>
 #include <ranges>
 #include <span>
@@ -20,9 +21,12 @@ struct StringPack
     StringPack(StringPack &&) = default;
     StringPack &operator=(StringPack &&) = default;
 
+    // The pack and the pointer lists it hands out live in scratch
     template <size_t EXTEND = std::dynamic_extent>
-    static constexpr std::optional<StringPack>
-        create(const std::span<std::string_view, EXTEND> &strings) noexcept
+    static std::optional<StringPack> create(
+        const std::span<std::string_view, EXTEND> &strings,
+        std::pmr::memory_resource *scratch =
+            std::pmr::get_default_resource()) noexcept
     try {
         const size_t total_size = [&strings]() {
             size_t output = 0;
@@ -32,9 +36,9 @@ struct StringPack
             return output;
         }();
 
-        std::vector<size_t> offsets;
+        std::pmr::vector<size_t> offsets(scratch);
         offsets.reserve(strings.size());
-        std::vector<char> data;
+        std::pmr::vector<char> data(scratch);
         data.reserve(total_size);
 
         size_t offset = 0;
@@ -49,7 +53,7 @@ struct StringPack
         // Just in case
         data.emplace_back(0);
 
-        StringPack output;
+        StringPack output(scratch);
         output.data = std::move(data);
         output.offsets = std::move(offsets);
         return std::make_optional(std::move(output));
@@ -61,11 +65,11 @@ struct StringPack
     ~StringPack() = default;
 
 
-    std::vector<const char *> get() && = delete;
+    std::pmr::vector<const char *> get() && = delete;
 
-    std::vector<const char *> get() &
+    std::pmr::vector<const char *> get() &
     {
-        std::vector<const char *> output;
+        std::pmr::vector<const char *> output(data.get_allocator());
         output.reserve(offsets.size());
         auto make_pointer = [this](size_t offset) -> const char * {
             return data.data() + offset;
@@ -76,9 +80,12 @@ struct StringPack
     }
 
   private:
-    StringPack() noexcept = default;
-    std::vector<char> data;
-    std::vector<size_t> offsets;
+    explicit StringPack(std::pmr::memory_resource *scratch) noexcept
+        : data(scratch), offsets(scratch)
+    {
+    }
+    std::pmr::vector<char> data;
+    std::pmr::vector<size_t> offsets;
 };
 
 } // namespace pvk::utils
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+#include <pvk/logger.hh>
+
+#include "pvk/internal/timeline.hh"
+#include "pvk/internal/vk_api.hh"
+
+namespace pvk {
+
+struct Submission
+{
+    // Null for a semaphore only submission
+    VkCommandBuffer command_buffer = VK_NULL_HANDLE;
+    VkSemaphore wait_semaphore = VK_NULL_HANDLE;
+    VkPipelineStageFlags wait_stage = 0;
+    VkSemaphore signal_semaphore = VK_NULL_HANDLE;
+    // Closes the batch: a vkQueueSubmit takes a single fence
+    VkFence fence = VK_NULL_HANDLE;
+};
+
+/*
+ * Owner of a VkQueue: any thread pushes submissions into a bounded
+ * lock-free MPSC ring, a single submitter thread drains it and hands
+ * everything pending to one vkQueueSubmit. Consecutive submissions
+ * without semaphores share a VkSubmitInfo. Every batch advances the
+ * timeline of the ring to its last ticket.
+ */
+class SubmitRing
+{
+  public:
+    static constexpr size_t capacity = 1024;
+    static constexpr size_t max_batch = 64;
+
+    SubmitRing(
+        VkQueue queue,
+        std::shared_ptr<Timeline> timeline,
+        std::string_view name);
+    // Submits whatever is still pending, pushing must have stopped
+    ~SubmitRing();
+
+    SubmitRing(const SubmitRing &) = delete;
+    SubmitRing &operator=(const SubmitRing &) = delete;
+
+    // Ticket of the submission, yields while the ring is full. The work
+    // is complete once the timeline reaches the ticket
+    uint64_t push(const Submission &submission) noexcept;
+
+    const std::shared_ptr<Timeline> &timeline() const noexcept
+    {
+        return m_timeline;
+    }
+
+    // Blocks until the ticket was handed to the driver
+    void wait_submitted(uint64_t ticket) const noexcept;
+    uint64_t submitted() const noexcept
+    {
+        return m_submitted.load(std::memory_order_acquire);
+    }
+
+    // Result of the latest failed vkQueueSubmit, VK_SUCCESS otherwise. Its
+    // tickets are failed on the timeline
+    VkResult last_error() const noexcept
+    {
+        return m_last_error.load(std::memory_order_relaxed);
+    }
+
+  private:
+    struct Cell
+    {
+        std::atomic<uint64_t> sequence;
+        Submission submission;
+    };
+
+    void run() noexcept;
+    bool ready() const noexcept;
+    size_t drain(std::vector<Submission> &batch) noexcept;
+    void submit(const std::vector<Submission> &batch) noexcept;
+    VkFence signal_timeline() noexcept;
+    void wake() noexcept;
+
+    std::unique_ptr<Cell[]> m_cells;
+    alignas(64) std::atomic<uint64_t> m_tail{0};
+    // Only touched by the submitter thread
+    alignas(64) uint64_t m_head = 0;
+    std::vector<VkSubmitInfo> m_infos;
+    std::vector<VkCommandBuffer> m_command_buffers;
+    uint64_t m_signal_value = 0;
+    VkTimelineSemaphoreSubmitInfo m_timeline_info{};
+
+    alignas(64) std::atomic<uint64_t> m_submitted{0};
+    std::atomic<uint32_t> m_wake{0};
+    std::atomic<bool> m_sleeping{false};
+    std::atomic<bool> m_stop{false};
+    std::atomic<VkResult> m_last_error{VK_SUCCESS};
+
+    VkQueue m_queue;
+    std::shared_ptr<Timeline> m_timeline;
+    // Null in fence mode
+    VkSemaphore m_timeline_semaphore;
+    Logger l;
+    std::thread m_thread;
+};
+
+} // namespace pvk
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <mutex>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+#include <pvk/logger.hh>
+#include <pvk/sync_pool_stats.hh>
+
+#include "pvk/internal/vk_api.hh"
+
+namespace pvk {
+
+/*
+ * Recycled fences, binary semaphores and events of a device. Released
+ * objects are reset lazily, all at once when an acquire finds no clean
+ * one left: a single vkResetFences covers every pending fence.
+ */
+class SyncPools
+{
+  public:
+    SyncPools(VkDevice device, const VkAllocationCallbacks *callbacks);
+    // Destroys the pooled objects, the device must be idle
+    ~SyncPools();
+
+    SyncPools(const SyncPools &) = delete;
+    SyncPools &operator=(const SyncPools &) = delete;
+
+    // Unsignaled objects, VK_NULL_HANDLE on failure. Objects are released
+    // once the device no longer uses them, signaled or not
+    VkFence acquire_fence() noexcept;
+    void release_fence(VkFence fence) noexcept;
+
+    // No pending signal or wait may remain on a released semaphore
+    VkSemaphore acquire_semaphore() noexcept;
+    void release_semaphore(VkSemaphore semaphore) noexcept;
+
+    VkEvent acquire_event() noexcept;
+    void release_event(VkEvent event) noexcept;
+
+    SyncPoolStats stats() const noexcept;
+
+  private:
+    template <typename Handle> struct Pool
+    {
+        mutable std::mutex lock;
+        std::vector<Handle> clean;
+        std::vector<Handle> dirty;
+        SyncPoolStats::Counters counters;
+    };
+
+    // create makes one object, reset cleans the dirty ones in place and
+    // returns its number of Vulkan calls
+    template <typename Handle, typename Create, typename Reset>
+    Handle acquire(Pool<Handle> &pool, Create create, Reset reset) noexcept;
+    // destroy is for a handle that cannot be pooled
+    template <typename Handle, typename Destroy>
+    void release(Pool<Handle> &pool, Handle handle, Destroy destroy) noexcept;
+    template <typename Handle, typename Destroy>
+    void destroy_all(Pool<Handle> &pool, Destroy destroy) noexcept;
+
+    VkDevice m_device;
+    const VkAllocationCallbacks *m_callbacks;
+
+    Pool<VkFence> m_fences;
+    Pool<VkSemaphore> m_semaphores;
+    Pool<VkEvent> m_events;
+
+    Logger l;
+};
+
+} // namespace pvk
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <span>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+#include <pvk/gpu_future.hh>
+#include <pvk/logger.hh>
+
+#include "pvk/internal/sync_pools.hh"
+#include "pvk/internal/vk_api.hh"
+
+namespace pvk {
+
+/*
+ * Monotonic completion counter of a queue, its values are the tickets of
+ * the SubmitRing of the queue. Backed by a Vulkan 1.2 timeline semaphore
+ * signaled once per batch, or on older devices by pooled fences, one per
+ * batch. A batch completes every value up to its own. The tickets of a
+ * failed submission are recorded as failed: they never report success,
+ * even once a later batch or the disconnect moves the counter past them.
+ */
+class Timeline
+{
+  public:
+    // nullptr when the semaphore cannot be created. Fence mode draws its
+    // fences from sync_pools, which must outlive retire
+    static std::shared_ptr<Timeline> create(
+        VkDevice device,
+        bool timeline_semaphores,
+        SyncPools *sync_pools,
+        const VkAllocationCallbacks *callbacks,
+        std::string_view name);
+
+    Timeline(const Timeline &) = delete;
+    Timeline &operator=(const Timeline &) = delete;
+
+    // Null in fence mode
+    VkSemaphore semaphore() const noexcept
+    {
+        return m_semaphore;
+    }
+
+    // Fence mode, submitter side: a fence for the next batch, then either
+    // signals(fence, value) once submitted or release(fence) on failure
+    VkFence acquire_fence() noexcept;
+    void signals(VkFence fence, uint64_t value) noexcept;
+    void release(VkFence fence) noexcept;
+
+    // Submitter side: the tickets first to last never reached the driver
+    void fail(uint64_t first, uint64_t last) noexcept;
+    bool failed(uint64_t value) noexcept;
+    // Number of failed submissions so far, to notice new ones
+    uint64_t failures() const noexcept
+    {
+        return m_failures.load(std::memory_order_acquire);
+    }
+
+    // Latest complete value, failed ones included. Runs the continuations
+    // it makes due and those of failed values
+    uint64_t completed() noexcept;
+    // False on timeout, device loss or failed submission
+    bool wait(uint64_t value, std::chrono::nanoseconds timeout) noexcept;
+    void then(uint64_t value, GpuFuture::Continuation continuation);
+
+    // Index of the first pair whose value completed or failed, nullopt on
+    // timeout.
+    // One vkWaitSemaphores when every timeline is a semaphore of the same
+    // device, polling with backoff otherwise
+    static std::optional<size_t> wait_any(
+        std::span<Timeline *const> timelines,
+        std::span<const uint64_t> values,
+        std::chrono::nanoseconds timeout) noexcept;
+
+    // Device is idle and about to be destroyed: every value completes and
+    // the Vulkan objects are released
+    void retire() noexcept;
+
+  private:
+    struct PendingFence
+    {
+        uint64_t value;
+        VkFence fence;
+    };
+
+    Timeline() = default;
+
+    uint64_t poll_fences() noexcept;
+    uint64_t advance(uint64_t value) noexcept;
+    void run_due(uint64_t completed_value) noexcept;
+
+    VkDevice m_device = VK_NULL_HANDLE;
+    VkSemaphore m_semaphore = VK_NULL_HANDLE;
+    const VkAllocationCallbacks *m_callbacks = nullptr;
+    std::atomic<uint64_t> m_completed{0};
+
+    // Shared by every use of the Vulkan objects, exclusive for retire
+    std::shared_mutex m_retire_lock;
+    bool m_retired = false;
+
+    // Fence mode: m_wait_lock is held by host waits and by anything that
+    // gives a fence back, so a fence never gets reset while waited on
+    SyncPools *m_sync_pools = nullptr;
+    std::mutex m_wait_lock;
+    std::mutex m_fence_lock;
+    std::deque<PendingFence> m_pending;
+
+    std::mutex m_failure_lock;
+    // Inclusive ticket ranges of the failed submissions, ascending
+    std::vector<std::pair<uint64_t, uint64_t>> m_failed;
+    std::atomic<uint64_t> m_failures{0};
+
+    std::mutex m_continuation_lock;
+    // Smallest value a continuation waits for, max when there is none
+    std::atomic<uint64_t> m_next_due{UINT64_MAX};
+    std::vector<std::pair<uint64_t, GpuFuture::Continuation>> m_continuations;
+
+    Logger l;
+};
+
+} // namespace pvk
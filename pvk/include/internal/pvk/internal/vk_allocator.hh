@@ -1,9 +1,20 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <string>
+#include <string_view>
 #include <unordered_map>
 
 #include <cstddef>
+#include <cstdint>
 
+#include <pvk/host_memory_stats.hh>
+
+#include "pvk/internal/alloc_trace.hh"
 #include "pvk/internal/vk_api.hh"
 
 namespace pvk {
@@ -18,7 +29,43 @@ struct Allocator
         VkSystemAllocationScope vk_scope;
     };
 
+    /*
+     * REGISTRY keeps block metadata in a hash map keyed by address and
+     * can detect frees of foreign pointers.
+     * HEADER stores metadata in an aligned header right before every
+     * block: free and realloc need no lookup and no extra heap traffic.
+     */
+    enum class BlockTracking
+    {
+        REGISTRY,
+        HEADER,
+    };
+
+    struct Options
+    {
+        BlockTracking tracking;
+        // Records every alloc, free and realloc when set
+        std::shared_ptr<AllocTrace> trace;
+        // Carves device and instance scoped blocks out of 2 MiB huge page
+        // slabs, silently falls back to regular slabs when unavailable
+        bool huge_pages;
+        // Preferred NUMA node of slab and page backed blocks
+        int numa_node;
+        // Serves every block instead of the built-in slabs when set, then
+        // huge_pages and numa_node are ignored. Calls into it are
+        // serialized, so it need not be synchronized itself. Must outlive
+        // the Allocator
+        std::pmr::memory_resource *backend;
+    };
+
+    static constexpr int any_numa_node = -1;
+
+    // Tracking by header, trace by PVK_ALLOCATION_TRACE and huge pages
+    // when PVK_HOST_HUGE_PAGES is set to anything but 0
+    static Options default_options() noexcept;
+
     Allocator() noexcept;
+    explicit Allocator(const Options &options) noexcept;
 
     // new Allocator passes its addres at creation
     // it should be alive at that specfic addres until it death
@@ -34,14 +81,84 @@ struct Allocator
         return &m_callbacks;
     }
 
-    std::unordered_map<MemBlock::Address, MemBlock> get_allocated_blocks()
+    std::unordered_map<MemBlock::Address, MemBlock> get_allocated_blocks();
+
+    // any_numa_node when the blocks are not bound to a node
+    int get_numa_node() const noexcept
     {
-        return m_blocks;
+        return m_numa_node;
     }
 
+    // Name of the pvk object the statistics are attributed to
+    void set_owner(std::string_view owner) noexcept;
+    HostMemoryStats snapshot() const noexcept;
+
   private:
     struct ImplFriend;
-    std::unordered_map<MemBlock::Address, MemBlock> m_blocks;
+
+    struct alignas(64) ScopeTelemetry
+    {
+        std::atomic<uint64_t> live_bytes{0};
+        std::atomic<uint64_t> peak_bytes{0};
+        std::atomic<uint64_t> allocations{0};
+        std::atomic<uint64_t> reallocations{0};
+        std::atomic<uint64_t> frees{0};
+        std::array<std::atomic<uint64_t>, HostMemoryStats::histogram_buckets>
+            size_histogram{};
+    };
+
+    struct InternalTelemetry
+    {
+        std::atomic<uint64_t> live_bytes{0};
+        std::atomic<uint64_t> peak_bytes{0};
+        std::atomic<uint64_t> allocations{0};
+        std::atomic<uint64_t> frees{0};
+    };
+
+    // Relaxed counters: a snapshot is not a consistent cut, but every
+    // counter in it is exact at the time it was read
+    struct Telemetry
+    {
+        std::array<ScopeTelemetry, HostMemoryStats::scope_count> scopes;
+        std::array<
+            std::array<InternalTelemetry, HostMemoryStats::scope_count>,
+            HostMemoryStats::internal_type_count>
+            internal;
+        alignas(64) std::atomic<uint64_t> live_bytes{0};
+        std::atomic<uint64_t> peak_bytes{0};
+        std::atomic<uint64_t> huge_page_bytes{0};
+    };
+
+    struct BlockHeader
+    {
+        BlockHeader *prev;
+        BlockHeader *next;
+        MemBlock meta;
+    };
+
+    // Drivers call back from any thread, so the block registry is split
+    // into independently locked shards picked by the block address
+    static constexpr size_t shard_count = 16;
+    struct alignas(64) Shard
+    {
+        std::mutex lock;
+        std::unordered_map<MemBlock::Address, MemBlock> blocks;
+        BlockHeader *headers = nullptr;
+    };
+
+    Shard &shard_of(MemBlock::Address addr)
+    {
+        return m_shards[((addr >> 6) ^ (addr >> 12)) % shard_count];
+    }
+
+    std::array<Shard, shard_count> m_shards;
+    BlockTracking m_tracking = BlockTracking::HEADER;
+    bool m_huge_pages = false;
+    int m_numa_node = any_numa_node;
+    std::pmr::memory_resource *m_backend = nullptr;
+    std::shared_ptr<AllocTrace> m_trace;
+    Telemetry m_telemetry;
+    std::string m_owner;
     VkAllocationCallbacks m_callbacks{};
 };
 
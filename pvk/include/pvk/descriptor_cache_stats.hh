@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace pvk {
+
+/*
+ * Snapshot of the descriptor caches of a device. A hit returns an object
+ * created before for the same description, a miss creates a new one.
+ */
+struct DescriptorCacheStats
+{
+    struct Counters
+    {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        // Objects currently held by the cache
+        uint64_t cached = 0;
+
+        double hit_rate() const
+        {
+            uint64_t lookups = hits + misses;
+            return lookups == 0 ? 0.0 : static_cast<double>(hits) / lookups;
+        }
+    };
+
+    Counters layouts;
+    Counters samplers;
+    // Sets keyed by the content of their bindings
+    Counters sets;
+
+    uint64_t pools = 0;
+    // vkResetDescriptorPool calls and the sets they freed at once
+    uint64_t pool_resets = 0;
+    uint64_t reset_sets = 0;
+};
+
+} // namespace pvk
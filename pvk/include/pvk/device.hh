@@ -1,10 +1,19 @@
 #pragma once
 
+#include <memory_resource>
+#include <optional>
 #include <string>
+#include <string_view>
 
 #include <cstddef>
 
+#include <pvk/descriptor_cache_stats.hh>
+#include <pvk/device_features.hh>
+#include <pvk/gpu_future.hh>
+#include <pvk/host_memory_stats.hh>
+#include <pvk/queue_plan.hh>
 #include <pvk/symvis.hh>
+#include <pvk/sync_pool_stats.hh>
 
 namespace pvk {
 
@@ -28,7 +37,55 @@ struct PVK_API alignas(std::max_align_t) Device
     DeviceType get_device_type();
 
     bool connect();
+    // scratch serves the temporaries of the connection
+    bool connect(std::pmr::memory_resource *scratch);
+    // Creates only the queues of plan, connect() asks for one per kind
+    bool connect(
+        const QueuePlan &plan,
+        std::pmr::memory_resource *scratch = std::pmr::get_default_resource());
+    // Fails when a required feature or extension is missing, the others
+    // are enabled when the device has them
+    bool connect(
+        const DeviceFeatureRequest &features,
+        std::pmr::memory_resource *scratch = std::pmr::get_default_resource());
+    bool connect(
+        const QueuePlan &plan,
+        const DeviceFeatureRequest &features,
+        std::pmr::memory_resource *scratch = std::pmr::get_default_resource());
     bool connected() const;
+    // Device wide descriptor arrays indexed through push constants, needs
+    // the Vulkan 1.2 descriptor indexing features
+    bool has_bindless() const noexcept;
+    // Reported by the device, whether enabled or not
+    bool supports(DeviceFeature feature) const noexcept;
+    // Granted by connect, false until connected
+    bool has_feature(DeviceFeature feature) const noexcept;
+    bool has_extension(std::string_view name) const noexcept;
+
+    HostMemoryStats get_host_memory_stats() const noexcept;
+    // Zeroed until connected
+    DescriptorCacheStats get_descriptor_cache_stats() const noexcept;
+    SyncPoolStats get_sync_pool_stats() const noexcept;
+
+    // Preferred NUMA node of the driver host memory, -1 when unbound.
+    // Derived from the PCI locality of the device when it is discoverable
+    int get_numa_node() const noexcept;
+    // Allowed only before connect, -1 unbinds
+    bool set_numa_node(int node) noexcept;
+
+    // Queues of a kind in plan order, empty until connected
+    size_t get_queue_count(QueueKind kind) const noexcept;
+    std::optional<QueueHandle>
+        get_queue(QueueKind kind, size_t nth) const noexcept;
+
+    // Completes once everything submitted to the queue so far has,
+    // ready right away when the device has no such queue
+    GpuFuture queue_future(QueueKind kind, size_t nth = 0) noexcept;
+    // End of a frame of the queue, every thread done recording for its
+    // family: the command buffers and descriptor sets used since the
+    // previous end_frame are recycled once the work submitted so far
+    // completes. The future completes with that work
+    GpuFuture end_frame(QueueKind kind, size_t nth = 0) noexcept;
 
     Device(Device const &) = delete;
     Device &operator=(Device const &) = delete;
@@ -40,6 +97,7 @@ struct PVK_API alignas(std::max_align_t) Device
     Device(Impl &&) noexcept;
 
     friend struct Instance;
+    friend struct Pipeline;
 };
 
 } // namespace pvk
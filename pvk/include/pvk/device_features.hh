@@ -0,0 +1,86 @@
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace pvk {
+
+// Features kernels pick faster code paths with, grouped by the Vulkan
+// version reporting them
+enum class DeviceFeature : uint32_t
+{
+    // 1.0
+    SHADER_FLOAT64,
+    SHADER_INT64,
+    SHADER_INT16,
+    // 1.1, reported from 1.2
+    STORAGE_BUFFER_16BIT,
+    UNIFORM_BUFFER_16BIT,
+    PUSH_CONSTANT_16BIT,
+    // 1.2
+    SHADER_FLOAT16,
+    SHADER_INT8,
+    STORAGE_BUFFER_8BIT,
+    UNIFORM_BUFFER_8BIT,
+    PUSH_CONSTANT_8BIT,
+    SHADER_BUFFER_INT64_ATOMICS,
+    SUBGROUP_EXTENDED_TYPES,
+    SCALAR_BLOCK_LAYOUT,
+    BUFFER_DEVICE_ADDRESS,
+    TIMELINE_SEMAPHORE,
+    VULKAN_MEMORY_MODEL,
+    HOST_QUERY_RESET,
+    // 1.3
+    SYNCHRONIZATION2,
+    SUBGROUP_SIZE_CONTROL,
+    COMPUTE_FULL_SUBGROUPS,
+    INTEGER_DOT_PRODUCT,
+    ZERO_INITIALIZE_WORKGROUP_MEMORY,
+    MAINTENANCE4,
+};
+inline constexpr size_t device_feature_count = 24;
+
+/*
+ * Features and extensions a Device enables on connect. A required one
+ * the device lacks fails the connection, an optional one is left out.
+ * Either way, what was granted is asked back from the connected Device.
+ * Timeline semaphores, the bindless table features and
+ * VK_KHR_push_descriptor are always asked for optionally.
+ */
+struct DeviceFeatureRequest
+{
+    std::vector<DeviceFeature> required;
+    std::vector<DeviceFeature> optional;
+    std::vector<std::string> required_extensions;
+    std::vector<std::string> optional_extensions;
+
+    DeviceFeatureRequest &require(DeviceFeature feature)
+    {
+        required.emplace_back(feature);
+        return *this;
+    }
+
+    DeviceFeatureRequest &prefer(DeviceFeature feature)
+    {
+        optional.emplace_back(feature);
+        return *this;
+    }
+
+    DeviceFeatureRequest &require_extension(std::string name)
+    {
+        required_extensions.emplace_back(std::move(name));
+        return *this;
+    }
+
+    DeviceFeatureRequest &prefer_extension(std::string name)
+    {
+        optional_extensions.emplace_back(std::move(name));
+        return *this;
+    }
+};
+
+} // namespace pvk
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <span>
+
+#include <cstddef>
+#include <cstdint>
+
+#include <pvk/symvis.hh>
+
+namespace pvk {
+
+class Timeline;
+
+/*
+ * Completion of GPU work: a value on the timeline of the queue that runs
+ * it. Futures are cheap to copy and stay valid after the device is
+ * disconnected, they are complete from then on.
+ */
+struct PVK_API GpuFuture
+{
+    // completed is false when the submission of the work failed
+    using Continuation = std::function<void(bool completed)>;
+    static constexpr std::chrono::nanoseconds forever =
+        std::chrono::nanoseconds::max();
+
+    // Already complete
+    GpuFuture() noexcept = default;
+    GpuFuture(std::shared_ptr<Timeline> timeline, uint64_t value) noexcept;
+
+    // Complete and not failed
+    bool ready() const noexcept;
+    // The submission of the work failed, it never completes
+    bool failed() const noexcept;
+    // False on timeout, device loss or failed submission
+    bool wait(std::chrono::nanoseconds timeout = forever) const noexcept;
+
+    /*
+     * Runs continuation once the work completes or its submission fails,
+     * right away when either already happened. Continuations run on the
+     * thread that observes it: a ready or wait call on any future of the
+     * queue.
+     */
+    void then(Continuation continuation) const;
+
+    static bool wait_all(
+        std::span<const GpuFuture> futures,
+        std::chrono::nanoseconds timeout = forever) noexcept;
+    // Index of a complete or failed future, nullopt on timeout
+    static std::optional<size_t> wait_any(
+        std::span<const GpuFuture> futures,
+        std::chrono::nanoseconds timeout = forever) noexcept;
+
+  private:
+    friend struct Reactor;
+
+    std::shared_ptr<Timeline> m_timeline;
+    uint64_t m_value = 0;
+};
+
+} // namespace pvk
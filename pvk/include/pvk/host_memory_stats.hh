@@ -0,0 +1,81 @@
+#pragma once
+
+#include <array>
+#include <string>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace pvk {
+
+/*
+ * Snapshot of the host memory the Vulkan driver requested through the
+ * allocation callbacks of a single pvk object.
+ * Scopes mirror VkSystemAllocationScope, internal allocation types
+ * mirror VkInternalAllocationType.
+ */
+struct HostMemoryStats
+{
+    enum class Scope
+    {
+        COMMAND,
+        OBJECT,
+        CACHE,
+        DEVICE,
+        INSTANCE,
+    };
+    static constexpr size_t scope_count = 5;
+
+    enum class InternalType
+    {
+        EXECUTABLE,
+    };
+    static constexpr size_t internal_type_count = 1;
+
+    // Bucket 0 counts blocks below 32 bytes, bucket N counts blocks in
+    // [2^(N+4), 2^(N+5)), the last bucket also counts everything bigger
+    static constexpr size_t histogram_buckets = 16;
+
+    struct Counters
+    {
+        uint64_t live_bytes = 0;
+        uint64_t peak_bytes = 0;
+        uint64_t allocations = 0;
+        uint64_t reallocations = 0;
+        uint64_t frees = 0;
+        std::array<uint64_t, histogram_buckets> size_histogram{};
+    };
+
+    // Driver allocations it did not route through the callbacks,
+    // reported by vkInternalAllocationNotification
+    struct InternalCounters
+    {
+        uint64_t live_bytes = 0;
+        uint64_t peak_bytes = 0;
+        uint64_t allocations = 0;
+        uint64_t frees = 0;
+    };
+
+    std::string owner;
+    Counters total;
+    std::array<Counters, scope_count> by_scope;
+    std::array<std::array<InternalCounters, scope_count>, internal_type_count>
+        internal;
+
+    // Preferred NUMA node of the object's host blocks, -1 when unbound
+    int numa_node = -1;
+
+    // Live bytes of this object carved out of huge page slabs
+    uint64_t huge_page_bytes = 0;
+    // Slab memory of the whole process mapped on huge pages and huge
+    // slab memory that had to fall back to regular pages
+    uint64_t process_huge_page_bytes = 0;
+    uint64_t process_huge_page_fallback_bytes = 0;
+
+    const Counters &of(Scope scope) const
+    {
+        return by_scope[static_cast<size_t>(scope)];
+    }
+};
+
+} // namespace pvk
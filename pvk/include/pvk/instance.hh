@@ -1,18 +1,48 @@
 #pragma once
 
+#include <chrono>
+#include <memory_resource>
 #include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
 
 #include <cstddef>
+#include <cstdint>
 
 #include <pvk/symvis.hh>
 
 #include <pvk/device.hh>
+#include <pvk/host_memory_stats.hh>
+#include <pvk/instance_options.hh>
 
 namespace pvk {
 
+struct DeviceConnectResult
+{
+    bool connected;
+    // Wall time of the connect call on its worker
+    std::chrono::nanoseconds latency;
+};
+
 struct PVK_API alignas(std::max_align_t) Instance
 {
     static std::optional<Instance> create() noexcept;
+
+    /*
+     * scratch serves the temporaries of the creation and may be released
+     * once it returns. host_backend, when set, serves the driver host
+     * allocations of the instance and of its devices and must outlive
+     * all of them. Drivers allocate from any thread, pvk serializes the
+     * calls into host_backend so an unsynchronized resource is fine.
+     */
+    static std::optional<Instance> create(
+        std::pmr::memory_resource *scratch,
+        std::pmr::memory_resource *host_backend = nullptr) noexcept;
+    static std::optional<Instance> create(
+        const InstanceOptions &options,
+        std::pmr::memory_resource *scratch = std::pmr::get_default_resource(),
+        std::pmr::memory_resource *host_backend = nullptr) noexcept;
     Instance(Instance &&) noexcept;
     Instance &operator=(Instance &&) noexcept;
     ~Instance() noexcept;
@@ -23,6 +53,22 @@ struct PVK_API alignas(std::max_align_t) Instance
     size_t get_device_count() const noexcept;
     std::optional<Device> get_device(size_t device_idx) const noexcept;
 
+    /*
+     * Connects every device concurrently on up to max_threads workers,
+     * 0 runs one worker per device. Returns once all of them are done,
+     * with one result per device in the same order.
+     */
+    std::vector<DeviceConnectResult> connect_devices(
+        std::span<Device> devices, size_t max_threads = 0) noexcept;
+
+    HostMemoryStats get_host_memory_stats() const noexcept;
+
+    // Negotiated with the loader, in the InstanceOptions::make_version
+    // encoding
+    uint32_t get_api_version() const noexcept;
+    // Enabled on creation, required or optional
+    bool has_extension(std::string_view name) const noexcept;
+
   private:
     static constexpr size_t impl_size = 256;
     std::byte impl[impl_size];
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <cstdint>
+
+#include <pvk/symvis.hh>
+
+namespace pvk {
+
+struct PVK_API InstanceOptions
+{
+    /*
+     * File keeping the layer, extension and format enumeration between
+     * runs, keyed by the loader, layer and driver versions so updates
+     * invalidate it. Empty disables it.
+     */
+    std::string capability_cache_path;
+
+    // VK_MAKE_API_VERSION without the Vulkan headers
+    static constexpr uint32_t
+        make_version(uint32_t major, uint32_t minor, uint32_t patch = 0)
+    {
+        return (major << 22) | (minor << 12) | patch;
+    }
+
+    // Highest Vulkan version asked for, lowered to the one the loader
+    // supports. Devices run at the lower of it and their own
+    uint32_t api_version = make_version(1, 3);
+
+    std::string application_name;
+    uint32_t application_version = 0;
+    std::string engine_name = "pvk";
+    uint32_t engine_version = 0;
+
+    // A required extension neither the loader nor a layer offers fails
+    // the creation, an optional one is left out
+    std::vector<std::string> required_extensions;
+    std::vector<std::string> optional_extensions;
+
+    // Capability cache from PVK_CAPABILITY_CACHE
+    static InstanceOptions default_options() noexcept;
+};
+
+} // namespace pvk
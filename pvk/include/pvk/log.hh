@@ -5,6 +5,26 @@
 
 namespace pvk {
 
+enum class LogLevel
+{
+    FATAL,
+    ERROR,
+    WARNING,
+    NOTICE,
+    INFO,
+    DEBUG,
+    TRACE
+};
+
+/*
+ * Most verbose level the global sink prints. Starts from PVK_LOG_LEVEL
+ * (fatal, error, warning, notice, info, debug or trace), TRACE when it
+ * is not set. Messages above it are neither formatted nor printed.
+ */
+void set_log_level(LogLevel level) noexcept;
+LogLevel get_log_level() noexcept;
+bool log_enabled(LogLevel level) noexcept;
+
 void raw_fatal(const std::string_view &message) noexcept;
 void raw_error(const std::string_view &message) noexcept;
 void raw_warning(const std::string_view &message) noexcept;
@@ -16,42 +36,63 @@ void raw_trace(const std::string_view &message) noexcept;
 template <typename... Args>
 void fatal(std::format_string<Args...> fmt, Args &&...args) noexcept
 {
+    if (!log_enabled(LogLevel::FATAL)) {
+        return;
+    }
     raw_fatal(std::vformat(fmt.get(), std::make_format_args(args...)));
 }
 
 template <typename... Args>
 void error(std::format_string<Args...> fmt, Args &&...args) noexcept
 {
+    if (!log_enabled(LogLevel::ERROR)) {
+        return;
+    }
     raw_error(std::vformat(fmt.get(), std::make_format_args(args...)));
 }
 
 template <typename... Args>
 void warning(std::format_string<Args...> fmt, Args &&...args) noexcept
 {
+    if (!log_enabled(LogLevel::WARNING)) {
+        return;
+    }
     raw_warning(std::vformat(fmt.get(), std::make_format_args(args...)));
 }
 
 template <typename... Args>
 void notice(std::format_string<Args...> fmt, Args &&...args) noexcept
 {
+    if (!log_enabled(LogLevel::NOTICE)) {
+        return;
+    }
     raw_notice(std::vformat(fmt.get(), std::make_format_args(args...)));
 }
 
 template <typename... Args>
 void info(std::format_string<Args...> fmt, Args &&...args) noexcept
 {
+    if (!log_enabled(LogLevel::INFO)) {
+        return;
+    }
     raw_info(std::vformat(fmt.get(), std::make_format_args(args...)));
 }
 
 template <typename... Args>
 void debug(std::format_string<Args...> fmt, Args &&...args) noexcept
 {
+    if (!log_enabled(LogLevel::DEBUG)) {
+        return;
+    }
     raw_debug(std::vformat(fmt.get(), std::make_format_args(args...)));
 }
 
 template <typename... Args>
 void trace(std::format_string<Args...> fmt, Args &&...args) noexcept
 {
+    if (!log_enabled(LogLevel::TRACE)) {
+        return;
+    }
     raw_trace(std::vformat(fmt.get(), std::make_format_args(args...)));
 }
 
@@ -4,20 +4,13 @@
 #include <string>
 #include <string_view>
 
+#include <pvk/log.hh>
+
 namespace pvk {
 
 struct Logger
 {
-    enum class Level
-    {
-        FATAL,
-        ERROR,
-        WARNING,
-        NOTICE,
-        INFO,
-        DEBUG,
-        TRACE
-    };
+    using Level = LogLevel;
 
     Logger() = default;
     Logger(Logger &&) = default;
@@ -29,6 +22,17 @@ struct Logger
 
     using Callback = void (*)(void *, Level, const std::string_view &) noexcept;
 
+    /*
+     * True when a message of that level reaches a sink: it passes the
+     * logger level and either a callback is set or the global sink
+     * prints it. Guard costly diagnostics with it.
+     */
+    bool enabled(Level level) const noexcept
+    {
+        return level <= m_level &&
+            (m_callback != nullptr || log_enabled(level));
+    }
+
     void raw_fatal(const std::string_view &message) const noexcept;
     void raw_error(const std::string_view &message) const noexcept;
     void raw_warning(const std::string_view &message) const noexcept;
@@ -40,42 +44,63 @@ struct Logger
     template <typename... Args>
     void fatal(std::format_string<Args...> fmt, Args &&...args) noexcept
     {
+        if (!enabled(Level::FATAL)) {
+            return;
+        }
         raw_fatal(std::vformat(fmt.get(), std::make_format_args(args...)));
     }
 
     template <typename... Args>
     void error(std::format_string<Args...> fmt, Args &&...args) noexcept
     {
+        if (!enabled(Level::ERROR)) {
+            return;
+        }
         raw_error(std::vformat(fmt.get(), std::make_format_args(args...)));
     }
 
     template <typename... Args>
     void warning(std::format_string<Args...> fmt, Args &&...args) noexcept
     {
+        if (!enabled(Level::WARNING)) {
+            return;
+        }
         raw_warning(std::vformat(fmt.get(), std::make_format_args(args...)));
     }
 
     template <typename... Args>
     void notice(std::format_string<Args...> fmt, Args &&...args) noexcept
     {
+        if (!enabled(Level::NOTICE)) {
+            return;
+        }
         raw_notice(std::vformat(fmt.get(), std::make_format_args(args...)));
     }
 
     template <typename... Args>
     void info(std::format_string<Args...> fmt, Args &&...args) noexcept
     {
+        if (!enabled(Level::INFO)) {
+            return;
+        }
         raw_info(std::vformat(fmt.get(), std::make_format_args(args...)));
     }
 
     template <typename... Args>
     void debug(std::format_string<Args...> fmt, Args &&...args) noexcept
     {
+        if (!enabled(Level::DEBUG)) {
+            return;
+        }
         raw_debug(std::vformat(fmt.get(), std::make_format_args(args...)));
     }
 
     template <typename... Args>
     void trace(std::format_string<Args...> fmt, Args &&...args) noexcept
     {
+        if (!enabled(Level::TRACE)) {
+            return;
+        }
         raw_trace(std::vformat(fmt.get(), std::make_format_args(args...)));
     }
 
@@ -85,12 +110,18 @@ struct Logger
     {
         m_user_data = user_data;
     }
+    // Most verbose level this logger forwards, TRACE by default
+    void set_level(Level level) noexcept
+    {
+        m_level = level;
+    }
 
   private:
     struct Detail;
     Callback m_callback = nullptr;
     void *m_user_data = nullptr;
     std::string m_source_name;
+    Level m_level = Level::TRACE;
 };
 
 } // namespace pvk
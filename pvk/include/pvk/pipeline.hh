@@ -1,11 +1,18 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 
 #include <memory>
 
 #include <optional>
+#include <span>
+#include <string_view>
 #include <pvk/device.hh>
+#include <pvk/gpu_future.hh>
+#include <pvk/host_memory_stats.hh>
+#include <pvk/pipeline_parameters.hh>
+#include <pvk/specialization.hh>
 #include <pvk/symvis.hh>
 
 namespace pvk {
@@ -19,11 +26,44 @@ struct PVK_API alignas(std::max_align_t) Pipeline
 
     Pipeline(const Pipeline &) = delete;
 
+    HostMemoryStats get_host_memory_stats() const noexcept;
+
+    // Bindings of the parameters, written at once from a packed host
+    // struct. Update templates are built for them, pushed straight into
+    // the command buffer when the device has VK_KHR_push_descriptor.
+    // Set before configure
+    bool set_parameters(std::span<const PipelineParameter> parameters) noexcept;
+    bool pushes_parameters() const noexcept;
+
+    // SPIR-V words of the compute shader, configure builds the pipeline
+    bool set_compute_shader(
+        std::span<const uint32_t> spirv,
+        std::string_view entry_point = "main") noexcept;
+    // Specializes the shader into the pipeline, again for another
+    // variant. The previous one is destroyed once its dispatches
+    // complete. Not concurrently with dispatch
+    bool configure(
+        std::span<const SpecializationConstant> constants = {}) noexcept;
+    bool configured() const noexcept;
+
+    // Records the pipeline, its parameters read from the packed host
+    // struct set_parameters described and a dispatch of groups_x *
+    // groups_y * groups_z workgroups, then submits them to the nth
+    // compute queue. parameters is ignored without set_parameters. The
+    // command buffer and descriptor set are recycled after the
+    // Device::end_frame of that queue. nullopt when nothing was submitted
+    std::optional<GpuFuture> dispatch(
+        const void *parameters,
+        uint32_t groups_x,
+        uint32_t groups_y = 1,
+        uint32_t groups_z = 1,
+        size_t nth_queue = 0) noexcept;
+
     Pipeline &operator=(const Pipeline &) = delete;
     Pipeline &operator=(Pipeline &&) = delete;
 
   private:
-    static constexpr size_t impl_size = 128;
+    static constexpr size_t impl_size = 256;
     std::byte impl[impl_size];
     struct Impl;
     Pipeline(Impl &&) noexcept;
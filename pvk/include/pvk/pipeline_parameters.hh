@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace pvk {
+
+enum class ParameterKind : uint32_t
+{
+    STORAGE_BUFFER,
+    UNIFORM_BUFFER,
+    STORAGE_IMAGE,
+    SAMPLED_IMAGE,
+    SAMPLER,
+    COMBINED_IMAGE_SAMPLER,
+    STORAGE_TEXEL_BUFFER,
+    UNIFORM_TEXEL_BUFFER,
+};
+
+/*
+ * One binding of the parameters of a pipeline and where its descriptors
+ * sit in the packed host struct the parameters are written from: count
+ * entries from offset, stride bytes apart. Buffers are read as a
+ * VkDescriptorBufferInfo, images and samplers as a VkDescriptorImageInfo
+ * and texel buffers as a VkBufferView. A zero stride is the size of that
+ * entry.
+ */
+struct PipelineParameter
+{
+    uint32_t binding = 0;
+    ParameterKind kind = ParameterKind::STORAGE_BUFFER;
+    uint32_t count = 1;
+    size_t offset = 0;
+    size_t stride = 0;
+};
+
+} // namespace pvk
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace pvk {
+
+enum class QueueKind
+{
+    GRAPHICS,
+    COMPUTE,
+    TRANSFER,
+};
+inline constexpr size_t queue_kind_count = 3;
+
+struct QueueRequest
+{
+    QueueKind kind;
+    // Vulkan queue priority in [0, 1]
+    float priority;
+};
+
+/*
+ * Queues a Device creates on connect. Every request is served from the
+ * most specialised family first: transfer-only families for TRANSFER,
+ * compute families without graphics for COMPUTE. Requests beyond the
+ * queues a family has share the queues already created in it.
+ */
+struct QueuePlan
+{
+    std::vector<QueueRequest> requests;
+
+    QueuePlan &add(QueueKind kind, size_t count = 1, float priority = 1.0f)
+    {
+        requests.insert(
+            std::end(requests), count, QueueRequest{kind, priority});
+        return *this;
+    }
+};
+
+struct QueueHandle
+{
+    QueueKind kind;
+    uint32_t family_idx;
+    uint32_t queue_idx;
+    // Served by the most specialised family for the kind
+    bool dedicated;
+    // Another request of the device got the same Vulkan queue
+    bool shared;
+};
+
+} // namespace pvk
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <coroutine>
+#include <functional>
+#include <optional>
+#include <utility>
+
+#include <cstddef>
+
+#include <pvk/gpu_future.hh>
+#include <pvk/symvis.hh>
+
+namespace pvk {
+
+/*
+ * Completion thread for coroutines awaiting GPU work. However many
+ * coroutines are suspended, it blocks once on the lowest pending value of
+ * every timeline involved and hands the coroutines whose work completed,
+ * or whose submission failed, to the executor.
+ */
+struct PVK_API alignas(std::max_align_t) Reactor
+{
+    // Resumes a coroutine; when empty, coroutines resume on the reactor
+    // thread and must not block it
+    using Executor = std::function<void(std::coroutine_handle<>)>;
+
+  private:
+    // Shared with the reactor thread, stays put when the Reactor moves
+    struct State;
+
+  public:
+    struct Awaitable
+    {
+        bool await_ready() const noexcept
+        {
+            return future.ready() || future.failed();
+        }
+
+        bool await_suspend(std::coroutine_handle<> handle)
+        {
+            return watch(state, future, handle);
+        }
+
+        // False when the submission of the work failed
+        bool await_resume() const noexcept
+        {
+            return !future.failed();
+        }
+
+        // The Reactor may move meanwhile, not be destroyed
+        State *state;
+        GpuFuture future;
+    };
+
+    static std::optional<Reactor> create(Executor executor = {}) noexcept;
+    Reactor(Reactor &&) noexcept;
+    // Waits for every awaited future, resumes its coroutine, then stops
+    ~Reactor() noexcept;
+
+    // bool completed = co_await reactor.completion(future);
+    Awaitable completion(GpuFuture future) noexcept;
+
+    // Suspended coroutines not handed to the executor yet, 0 once moved
+    size_t pending() const noexcept;
+
+    Reactor(const Reactor &) = delete;
+    Reactor &operator=(const Reactor &) = delete;
+    Reactor &operator=(Reactor &&) = delete;
+
+  private:
+    // False when the future has no timeline to wait for or the reactor
+    // was moved from
+    static bool watch(
+        State *state,
+        const GpuFuture &future,
+        std::coroutine_handle<> handle);
+
+    static constexpr size_t impl_size = 64;
+    std::byte impl[impl_size];
+    struct Impl;
+    Reactor(Impl &&) noexcept;
+};
+
+} // namespace pvk
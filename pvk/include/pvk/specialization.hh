@@ -0,0 +1,42 @@
+#pragma once
+
+#include <array>
+#include <cstring>
+#include <type_traits>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace pvk {
+
+/*
+ * Value of a specialization constant of a shader, picked by its
+ * constant_id. Workgroup sizes, unroll factors and feature toggles set
+ * this way turn one SPIR-V module into variants tuned per device.
+ */
+struct SpecializationConstant
+{
+    uint32_t id = 0;
+    // 4 bytes for bool, 32-bit ints and floats, 8 for the 64-bit ones
+    uint32_t size = 0;
+    std::array<std::byte, 8> data{};
+
+    // Booleans are 32-bit in SPIR-V
+    static SpecializationConstant make(uint32_t id, bool value) noexcept
+    {
+        return make(id, static_cast<uint32_t>(value ? 1 : 0));
+    }
+
+    template <typename T>
+        requires(std::is_arithmetic_v<T> && (sizeof(T) == 4 || sizeof(T) == 8))
+    static SpecializationConstant make(uint32_t id, T value) noexcept
+    {
+        SpecializationConstant output;
+        output.id = id;
+        output.size = sizeof(T);
+        std::memcpy(output.data.data(), &value, sizeof(T));
+        return output;
+    }
+};
+
+} // namespace pvk
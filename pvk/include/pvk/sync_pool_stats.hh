@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace pvk {
+
+/*
+ * Snapshot of the fence, semaphore and event pools of a device. A hit is
+ * an acquire served by a recycled object, a miss creates a new one.
+ */
+struct SyncPoolStats
+{
+    struct Counters
+    {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        // Objects waiting in the pool, reset or not
+        uint64_t pooled = 0;
+        // Objects handed out and not released yet
+        uint64_t in_use = 0;
+        // Reset calls and the objects they covered, fences are reset
+        // many per vkResetFences
+        uint64_t resets = 0;
+        uint64_t reset_objects = 0;
+
+        double hit_rate() const
+        {
+            uint64_t acquires = hits + misses;
+            return acquires == 0 ? 0.0 : static_cast<double>(hits) / acquires;
+        }
+    };
+
+    Counters fences;
+    // Binary semaphores, recycled without reset
+    Counters semaphores;
+    Counters events;
+};
+
+} // namespace pvk
@@ -1,19 +1,26 @@
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <format>
 #include <memory>
+#include <memory_resource>
 #include <optional>
 #include <span>
 #include <string>
 #include <string_view>
+#include <system_error>
+#include <thread>
 #include <unordered_set>
 #include <utility>
 #include <vector>
 
 #include <cstddef>
 #include <cstdint>
+#include <cstdlib>
 
 #include <pvk/device.hh>
 #include <pvk/instance.hh>
+#include <pvk/instance_options.hh>
 #include <pvk/log.hh>
 #include <pvk/logger.hh>
 
@@ -24,10 +31,12 @@
 
 #include "pvk/internal/vk_api.hh"
 #include "pvk/internal/vk_allocator.hh"
+#include "pvk/internal/capability_cache.hh"
 #include "pvk/internal/device_impl.hh"
 #include "pvk/internal/instance_impl.hh"
 #include "pvk/internal/layer_utils.hh"
 #include "pvk/internal/log_utils.hh"
+#include "pvk/internal/physical_device_info.hh"
 #include "pvk/internal/result.hh"
 #include "pvk/internal/string_pack.hh"
 
@@ -68,30 +77,101 @@ Instance::Impl::~Impl() noexcept
 #endif
 }
 
+InstanceOptions InstanceOptions::default_options() noexcept
+try {
+    InstanceOptions output;
+    const char *cache_path = std::getenv("PVK_CAPABILITY_CACHE");
+    if (cache_path != nullptr) {
+        output.capability_cache_path = cache_path;
+    }
+    return output;
+} catch (...) {
+    return InstanceOptions();
+}
+
 std::optional<Instance> Instance::create() noexcept
 {
-    return Instance::Impl::create();
+    return Instance::Impl::create(
+        InstanceOptions::default_options(),
+        std::pmr::get_default_resource(),
+        nullptr);
+}
+
+std::optional<Instance> Instance::create(
+    std::pmr::memory_resource *scratch,
+    std::pmr::memory_resource *host_backend) noexcept
+{
+    return create(InstanceOptions::default_options(), scratch, host_backend);
+}
+
+std::optional<Instance> Instance::create(
+    const InstanceOptions &options,
+    std::pmr::memory_resource *scratch,
+    std::pmr::memory_resource *host_backend) noexcept
+{
+    if (scratch == nullptr) {
+        scratch = std::pmr::get_default_resource();
+    }
+    return Instance::Impl::create(options, scratch, host_backend);
 }
 
-std::optional<Instance> Instance::Impl::create()
+std::optional<Instance> Instance::Impl::create(
+    const InstanceOptions &options,
+    std::pmr::memory_resource *scratch,
+    std::pmr::memory_resource *host_backend)
 {
     Instance::Impl impl;
-    impl.m_allocator = std::make_unique<Allocator>();
+    Allocator::Options alloc_options = Allocator::default_options();
+    alloc_options.backend = host_backend;
+    impl.m_allocator = std::make_unique<Allocator>(alloc_options);
+    impl.m_host_backend = host_backend;
+    impl.m_allocator->set_owner("Instance");
     impl.l.set_name("InstanceContext");
 
     Logger &l = impl.l;
 
-    std::unordered_set<std::string> full_extesions_list;
-    std::vector<std::string_view> enabled_layers;
-    std::vector<std::string_view> enabled_extensions;
+    NameSet full_extesions_list(scratch);
+    std::pmr::vector<std::string_view> enabled_layers(scratch);
+    std::pmr::vector<std::string_view> enabled_extensions(scratch);
 
-    auto implicit_extensions = get_instance_layer_extensions(nullptr, l);
-    for (auto &implicit_extension : implicit_extensions) {
-        full_extesions_list.emplace(std::move(implicit_extension));
+    std::optional<CapabilityCache> cache;
+    if (!options.capability_cache_path.empty()) {
+        cache = CapabilityCache::load(options.capability_cache_path, l);
     }
 
-    std::unordered_set<std::string> vk_layers = get_instance_layers(l);
-    LayerExtMap layer_extensions = get_instance_layers_extensions(vk_layers, l);
+    // The layer list and implementation extensions are the cache key,
+    // only the per layer extension enumeration can be skipped
+    CapabilityCache::InstanceKey cache_key;
+    cache_key.loader_version = loader_version();
+    auto layer_props = get_instance_layer_properties(l, scratch);
+    cache_key.layers.assign(std::begin(layer_props), std::end(layer_props));
+    auto implicit_extensions =
+        get_instance_extension_properties(nullptr, l, scratch);
+    cache_key.extensions.assign(
+        std::begin(implicit_extensions), std::end(implicit_extensions));
+
+    for (auto &implicit_extension : cache_key.extensions) {
+        full_extesions_list.emplace(implicit_extension.extensionName);
+    }
+
+    NameSet vk_layers = layer_names(layer_props, l, scratch);
+    LayerExtMap layer_extensions(scratch);
+
+    std::optional<std::vector<LayerExtensions>> cached_layers;
+    if (cache) {
+        cached_layers = cache->find_instance(cache_key);
+    }
+    if (cached_layers) {
+        l.debug("Instance layer extensions restored from capability cache");
+        layer_extensions = to_layer_map(*cached_layers, scratch);
+    } else {
+        layer_extensions =
+            get_instance_layers_extensions(vk_layers, l, scratch);
+        if (cache) {
+            cache->put_instance(
+                std::move(cache_key), to_layer_list(layer_extensions));
+        }
+    }
 
     for (auto &layer : layer_extensions) {
         for (auto &layer_ext_name : layer.second) {
@@ -109,11 +189,10 @@ std::optional<Instance> Instance::Impl::create()
         l.notice("Layer \"VK_LAYER_KHRONOS_validation\" is not available");
     }
 #endif
-    if (full_extesions_list.size() != 0) {
-
+    if (full_extesions_list.size() != 0 && l.enabled(Logger::Level::INFO)) {
         std::string label = "All instance extensions";
         size_t max_line_size = label.size() + 2;
-        std::vector<std::string> lines;
+        std::pmr::vector<std::string_view> lines(scratch);
         lines.reserve(full_extesions_list.size());
 
         for (auto &ext : full_extesions_list) {
@@ -165,10 +244,60 @@ std::optional<Instance> Instance::Impl::create()
     }
 #endif
 
+    auto enable_extension = [&](std::string_view name) {
+        if (std::ranges::find(enabled_extensions, name) ==
+            std::end(enabled_extensions)) {
+            enabled_extensions.emplace_back(name);
+        }
+    };
+    auto offered = [&](const std::string &name) {
+        return full_extesions_list.contains(std::pmr::string(name, scratch));
+    };
+    for (const std::string &name : options.required_extensions) {
+        if (!offered(name)) {
+            l.warning(
+                "Creating vulkan context failue: Extension {} is not "
+                "available",
+                name);
+            return std::nullopt;
+        }
+        enable_extension(name);
+    }
+    for (const std::string &name : options.optional_extensions) {
+        if (!offered(name)) {
+            l.notice("Extension {} is not available: Ignore", name);
+            continue;
+        }
+        enable_extension(name);
+    }
+
+    // Loaders older than 1.1 do not have the query and only run 1.0
+    uint32_t loader_version = VK_API_VERSION_1_0;
+    if (vkEnumerateInstanceVersion != nullptr) {
+        VkResult version_status = vkEnumerateInstanceVersion(&loader_version);
+        if (version_status != VK_SUCCESS) {
+            l.warning(
+                "Querying loader version failue: {}",
+                vk_to_str(version_status));
+            loader_version = VK_API_VERSION_1_0;
+        }
+    }
+    impl.m_api_version = std::max(
+        VK_API_VERSION_1_0, std::min(options.api_version, loader_version));
+    l.info(
+        "Vulkan {}.{} requested, {}.{} used, loader supports {}.{}.{}",
+        VK_API_VERSION_MAJOR(options.api_version),
+        VK_API_VERSION_MINOR(options.api_version),
+        VK_API_VERSION_MAJOR(impl.m_api_version),
+        VK_API_VERSION_MINOR(impl.m_api_version),
+        VK_API_VERSION_MAJOR(loader_version),
+        VK_API_VERSION_MINOR(loader_version),
+        VK_API_VERSION_PATCH(loader_version));
+
     auto enabled_layer_names =
-        utils::StringPack::create(std::span(enabled_layers));
+        utils::StringPack::create(std::span(enabled_layers), scratch);
     auto enabled_ext_names =
-        utils::StringPack::create(std::span(enabled_extensions));
+        utils::StringPack::create(std::span(enabled_extensions), scratch);
     if (!enabled_layer_names || !enabled_ext_names) {
         return std::nullopt;
     }
@@ -179,8 +308,15 @@ std::optional<Instance> Instance::Impl::create()
     VkApplicationInfo vk_app_info{};
     VkInstanceCreateInfo vk_instance_info{};
     vk_app_info.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
-    vk_app_info.pApplicationName = "Some name";
-    vk_app_info.apiVersion = VK_MAKE_API_VERSION(0, 1, 0, 0);
+    if (!options.application_name.empty()) {
+        vk_app_info.pApplicationName = options.application_name.c_str();
+    }
+    vk_app_info.applicationVersion = options.application_version;
+    if (!options.engine_name.empty()) {
+        vk_app_info.pEngineName = options.engine_name.c_str();
+    }
+    vk_app_info.engineVersion = options.engine_version;
+    vk_app_info.apiVersion = impl.m_api_version;
     vk_instance_info.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
     vk_instance_info.pApplicationInfo = &vk_app_info;
     vk_instance_info.enabledLayerCount = en_layer_names_ptrs.size();
@@ -216,6 +352,8 @@ std::optional<Instance> Instance::Impl::create()
         return std::nullopt;
     }
     impl.m_vk_instance = new_instance;
+    impl.m_enabled_extensions.assign(
+        std::begin(enabled_extensions), std::end(enabled_extensions));
     l.info(
         "Created instance with handle 0x{:x}",
         reinterpret_cast<size_t>(impl.m_vk_instance));
@@ -251,15 +389,21 @@ std::optional<Instance> Instance::Impl::create()
     }
 #endif
 
-    if (!impl.load_devices()) {
+    if (!impl.load_devices(scratch, cache ? &*cache : nullptr)) {
         l.warning("Loading physical device list failue");
         return std::nullopt;
     }
 
+    // Losing the cache only costs the next startup its enumeration
+    if (cache && cache->dirty()) {
+        cache->store(l);
+    }
+
     return Instance(std::move(impl));
 }
 
-bool Instance::Impl::load_devices()
+bool Instance::Impl::load_devices(
+    std::pmr::memory_resource *scratch, CapabilityCache *cache)
 {
     uint32_t cnt_devices = 0;
     VkResult dev_enum_status =
@@ -274,8 +418,7 @@ bool Instance::Impl::load_devices()
         return false;
     }
 
-    std::vector<VkPhysicalDevice> devices;
-    devices.resize(cnt_devices);
+    std::pmr::vector<VkPhysicalDevice> devices(cnt_devices, scratch);
     dev_enum_status =
         vkEnumeratePhysicalDevices(m_vk_instance, &cnt_devices, devices.data());
     if (dev_enum_status != VK_SUCCESS) {
@@ -286,7 +429,14 @@ bool Instance::Impl::load_devices()
         return {};
     }
 
-    m_devices = devices;
+    m_devices.assign(std::begin(devices), std::end(devices));
+
+    m_device_infos.clear();
+    m_device_infos.reserve(m_devices.size());
+    for (VkPhysicalDevice device : m_devices) {
+        m_device_infos.emplace_back(std::make_shared<PhysicalDeviceInfo>(
+            PhysicalDeviceInfo::query(device, m_api_version, l, cache)));
+    }
     return true;
 }
 
@@ -333,8 +483,12 @@ Instance::Instance(Instance &&other) noexcept
 
 Instance::Impl::Impl(Instance::Impl &&other) noexcept
     : m_allocator(std::move(other.m_allocator)),
+      m_host_backend(other.m_host_backend),
       m_vk_instance(std::move(other.m_vk_instance)), l(std::move(other.l)),
-      m_devices(std::move(other.m_devices))
+      m_api_version(other.m_api_version),
+      m_enabled_extensions(std::move(other.m_enabled_extensions)),
+      m_devices(std::move(other.m_devices)),
+      m_device_infos(std::move(other.m_device_infos))
 #if (PVK_USE_EXT_DEBUG_UTILS)
       ,
       instance_spy(std::move(other.instance_spy)),
@@ -362,6 +516,92 @@ std::optional<Device> Instance::get_device(size_t device_idx) const noexcept
     return IMPL.get_device(device_idx);
 }
 
+HostMemoryStats Instance::get_host_memory_stats() const noexcept
+{
+    return IMPL.get_host_memory_stats();
+}
+
+uint32_t Instance::get_api_version() const noexcept
+{
+    return IMPL.get_api_version();
+}
+
+bool Instance::has_extension(std::string_view name) const noexcept
+{
+    return IMPL.has_extension(name);
+}
+
+std::vector<DeviceConnectResult> Instance::connect_devices(
+    std::span<Device> devices, size_t max_threads) noexcept
+try {
+    return IMPL.connect_devices(devices, max_threads);
+} catch (...) {
+    return std::vector<DeviceConnectResult>(
+        devices.size(), DeviceConnectResult{false, {}});
+}
+
+std::vector<DeviceConnectResult> Instance::Impl::connect_devices(
+    std::span<Device> devices, size_t max_threads)
+{
+    std::vector<DeviceConnectResult> output(
+        devices.size(), DeviceConnectResult{false, {}});
+    if (devices.empty()) {
+        return output;
+    }
+
+    size_t nb_workers = max_threads == 0
+        ? devices.size()
+        : std::min(max_threads, devices.size());
+
+    // Workers pull the next device, so one slow device only holds back
+    // its own worker
+    std::atomic<size_t> next_device{0};
+    auto worker = [&]() {
+        std::pmr::monotonic_buffer_resource scratch;
+        for (size_t device_idx = next_device.fetch_add(1);
+             device_idx < devices.size();
+             device_idx = next_device.fetch_add(1)) {
+            auto start = std::chrono::steady_clock::now();
+            bool connected = false;
+            try {
+                connected = devices[device_idx].connect(&scratch);
+            } catch (...) {
+                l.warning("Device {} connection failue: No memory", device_idx);
+            }
+            auto stop = std::chrono::steady_clock::now();
+            scratch.release();
+
+            output[device_idx] = DeviceConnectResult{connected, stop - start};
+        }
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(nb_workers - 1);
+    for (size_t worker_idx = 1; worker_idx < nb_workers; worker_idx++) {
+        try {
+            workers.emplace_back(worker);
+        } catch (const std::system_error &) {
+            // Fewer workers only cost latency
+            l.notice("Connect worker #{} creation failue", worker_idx);
+            break;
+        }
+    }
+    // The calling thread is the first worker
+    worker();
+    std::ranges::for_each(workers, [](auto &t) { t.join(); });
+
+    for (size_t device_idx = 0; device_idx < devices.size(); device_idx++) {
+        const DeviceConnectResult &result = output[device_idx];
+        l.info(
+            "Device {} \"{}\" {} in {:.3f} ms",
+            device_idx,
+            devices[device_idx].get_name(),
+            result.connected ? "connected" : "failed to connect",
+            std::chrono::duration<double, std::milli>(result.latency).count());
+    }
+    return output;
+}
+
 std::optional<Device>
     Instance::Impl::get_device(size_t device_idx) const noexcept
 {
@@ -371,7 +611,8 @@ std::optional<Device>
 
     VkPhysicalDevice physical_device = m_devices[device_idx];
 
-    Device::Impl i(std::move(physical_device));
+    Device::Impl i(
+        std::move(physical_device), m_device_infos[device_idx], m_host_backend);
 
     return Device(std::move(i));
 }
@@ -1,6 +1,7 @@
 #include <algorithm>
 #include <cstddef>
 #include <format>
+#include <memory_resource>
 #include <string>
 #include <string_view>
 #include <unordered_set>
@@ -21,7 +22,7 @@ namespace pvk {
 void dump_extensions_per_layer(
     const LayerExtMap &lay_exts, std::string_view label, Logger &l)
 {
-    if (lay_exts.size() == 0) {
+    if (lay_exts.size() == 0 || !l.enabled(Logger::Level::INFO)) {
         return;
     }
 
@@ -63,31 +64,66 @@ void dump_extensions_per_layer(
     l.info("{}", box_foot(max_line_size));
 }
 
-namespace {
-std::unordered_set<std::string>
-    collect_layers(const std::vector<VkLayerProperties> &layers, Logger &l)
+std::vector<LayerExtensions> to_layer_list(const LayerExtMap &layer_extensions)
+{
+    std::vector<LayerExtensions> output;
+    output.reserve(layer_extensions.size());
+    for (const auto &[layer, extensions] : layer_extensions) {
+        LayerExtensions &entry = output.emplace_back();
+        entry.layer = layer;
+        entry.extensions.assign(std::begin(extensions), std::end(extensions));
+        std::ranges::sort(entry.extensions);
+    }
+    std::ranges::sort(output, {}, &LayerExtensions::layer);
+    return output;
+}
+
+LayerExtMap to_layer_map(
+    const std::vector<LayerExtensions> &layer_list,
+    std::pmr::memory_resource *scratch)
+{
+    LayerExtMap output(scratch);
+    output.reserve(layer_list.size());
+    for (const auto &entry : layer_list) {
+        NameSet extensions(scratch);
+        extensions.reserve(entry.extensions.size());
+        for (const auto &extension : entry.extensions) {
+            extensions.emplace(extension);
+        }
+        output.emplace(entry.layer, std::move(extensions));
+    }
+    return output;
+}
+
+NameSet layer_names(
+    const std::pmr::vector<VkLayerProperties> &layers,
+    Logger &l,
+    std::pmr::memory_resource *scratch)
 {
-    std::unordered_set<std::string> output;
+    NameSet output(scratch);
     output.reserve(layers.size());
     for (auto &layer : layers) {
-        std::string layer_name(layer.layerName);
+        std::pmr::string layer_name(layer.layerName, scratch);
         if (output.contains(layer_name)) {
             l.warning("Layer {} mentioned more than once", layer_name);
             continue;
         }
-        output.emplace(layer_name);
+        output.emplace(std::move(layer_name));
     }
 
     return output;
 };
 
-std::unordered_set<std::string> collect_extensions(
-    const std::vector<VkExtensionProperties> &extensions, Logger &l)
+namespace {
+NameSet collect_extensions(
+    const std::pmr::vector<VkExtensionProperties> &extensions,
+    Logger &l,
+    std::pmr::memory_resource *scratch)
 {
-    std::unordered_set<std::string> output;
+    NameSet output(scratch);
     output.reserve(extensions.size());
     for (auto &ext : extensions) {
-        std::string ext_name(ext.extensionName);
+        std::pmr::string ext_name(ext.extensionName, scratch);
         if (output.contains(ext_name)) {
             std::string dup_warn = std::format(
                 "Extention \"{}\" mentioned more than once", ext_name);
@@ -99,9 +135,42 @@ std::unordered_set<std::string> collect_extensions(
     return output;
 }
 
+template <typename LAYER_EXTENSIONS_FN>
+LayerExtMap collect_layers_extensions(
+    const NameSet &layer_names,
+    Logger &l,
+    std::pmr::memory_resource *scratch,
+    LAYER_EXTENSIONS_FN &&layer_extensions_fn)
+{
+    LayerExtMap output(scratch);
+    for (const auto &layer_name : layer_names) {
+        NameSet layer_extensions = layer_extensions_fn(layer_name.c_str());
+
+        auto layer_extensions_list = output.find(layer_name);
+
+        if (layer_extensions_list == std::end(output)) {
+            NameSet new_extension_list(scratch);
+            new_extension_list.reserve(layer_extensions.size());
+            output.emplace(layer_name, std::move(new_extension_list));
+
+            layer_extensions_list = output.find(layer_name);
+            if (layer_extensions_list == std::end(output)) {
+                l.error("No memory for layers extension list");
+                continue;
+            }
+        }
+
+        for (auto &extension : layer_extensions) {
+            layer_extensions_list->second.emplace(std::move(extension));
+        }
+    }
+    return output;
+}
+
 } // namespace
 
-std::unordered_set<std::string> get_instance_layers(Logger &l)
+std::pmr::vector<VkLayerProperties> get_instance_layer_properties(
+    Logger &l, std::pmr::memory_resource *scratch)
 {
     uint32_t nb_layers = 0;
     VkResult get_nb_layers_status =
@@ -111,10 +180,10 @@ std::unordered_set<std::string> get_instance_layers(Logger &l)
         l.warning(
             "Cannot retreave instance layer count ({}): Assume no layers",
             vk_to_str(get_nb_layers_status));
-        return {};
+        return std::pmr::vector<VkLayerProperties>(scratch);
     }
 
-    std::vector<VkLayerProperties> available_layers(nb_layers);
+    std::pmr::vector<VkLayerProperties> available_layers(nb_layers, scratch);
     VkResult get_layers_status =
         vkEnumerateInstanceLayerProperties(&nb_layers, available_layers.data());
 
@@ -122,14 +191,19 @@ std::unordered_set<std::string> get_instance_layers(Logger &l)
         l.warning(
             "Cannot retreave instance layers ({}): Assume no layers",
             vk_to_str(get_layers_status));
-        return {};
+        return std::pmr::vector<VkLayerProperties>(scratch);
     }
 
-    return collect_layers(available_layers, l);
+    return available_layers;
+}
+
+NameSet get_instance_layers(Logger &l, std::pmr::memory_resource *scratch)
+{
+    return layer_names(get_instance_layer_properties(l, scratch), l, scratch);
 }
 
-std::unordered_set<std::string>
-    get_device_layers(VkPhysicalDevice device, Logger &l)
+NameSet get_device_layers(
+    VkPhysicalDevice device, Logger &l, std::pmr::memory_resource *scratch)
 {
     uint32_t nb_layers = 0;
     VkResult get_nb_layers_status =
@@ -139,10 +213,10 @@ std::unordered_set<std::string>
         l.warning(
             "Cannot retreave device layers count ({}): Assume no layers",
             vk_to_str(get_nb_layers_status));
-        return {};
+        return NameSet(scratch);
     }
 
-    std::vector<VkLayerProperties> available_layers(nb_layers);
+    std::pmr::vector<VkLayerProperties> available_layers(nb_layers, scratch);
     VkResult get_layers_status = vkEnumerateDeviceLayerProperties(
         device, &nb_layers, available_layers.data());
 
@@ -150,14 +224,14 @@ std::unordered_set<std::string>
         l.warning(
             "Cannot retreave device layers ({}): Assume no layers",
             vk_to_str(get_nb_layers_status));
-        return {};
+        return NameSet(scratch);
     }
 
-    return collect_layers(available_layers, l);
+    return layer_names(available_layers, l, scratch);
 }
 
-std::unordered_set<std::string>
-    get_instance_layer_extensions(const char *layer_name, Logger &l)
+std::pmr::vector<VkExtensionProperties> get_instance_extension_properties(
+    const char *layer_name, Logger &l, std::pmr::memory_resource *scratch)
 {
     uint32_t nb_extensions = 0;
     VkResult get_nb_status = vkEnumerateInstanceExtensionProperties(
@@ -168,10 +242,10 @@ std::unordered_set<std::string>
             "Cannot retreave instance layers extension count ({}): Assume no "
             "instance layers",
             vk_to_str(get_nb_status));
-        return {};
+        return std::pmr::vector<VkExtensionProperties>(scratch);
     }
 
-    std::vector<VkExtensionProperties> layer_exts(nb_extensions);
+    std::pmr::vector<VkExtensionProperties> layer_exts(nb_extensions, scratch);
     VkResult get_layers_status = vkEnumerateInstanceExtensionProperties(
         layer_name, &nb_extensions, layer_exts.data());
 
@@ -181,43 +255,33 @@ std::unordered_set<std::string>
             "instance "
             "layers",
             vk_to_str(get_layers_status));
-        return {};
+        return std::pmr::vector<VkExtensionProperties>(scratch);
     }
 
-    return collect_extensions(layer_exts, l);
+    return layer_exts;
 }
 
-LayerExtMap get_instance_layers_extensions(
-    const std::unordered_set<std::string> &layer_names, Logger &l)
+NameSet get_instance_layer_extensions(
+    const char *layer_name, Logger &l, std::pmr::memory_resource *scratch)
 {
-    LayerExtMap output;
-    for (const auto &layer_name : layer_names) {
-        std::unordered_set<std::string> layer_extensions =
-            get_instance_layer_extensions(layer_name.c_str(), l);
-
-        auto layer_extensions_list = output.find(layer_name);
-
-        if (layer_extensions_list == std::end(output)) {
-            std::unordered_set<std::string> new_extension_list;
-            new_extension_list.reserve(layer_extensions.size());
-            output.emplace(layer_name, std::move(new_extension_list));
-
-            layer_extensions_list = output.find(layer_name);
-            if (layer_extensions_list == std::end(output)) {
-                l.error("No memory for layers extension list");
-                continue;
-            }
-        }
+    return collect_extensions(
+        get_instance_extension_properties(layer_name, l, scratch), l, scratch);
+}
 
-        for (auto &extension : layer_extensions) {
-            layer_extensions_list->second.emplace(std::move(extension));
-        }
-    }
-    return output;
+LayerExtMap get_instance_layers_extensions(
+    const NameSet &layer_names, Logger &l, std::pmr::memory_resource *scratch)
+{
+    return collect_layers_extensions(
+        layer_names, l, scratch, [&l, scratch](const char *layer_name) {
+            return get_instance_layer_extensions(layer_name, l, scratch);
+        });
 }
 
-std::unordered_set<std::string> get_device_layer_extensions(
-    const VkPhysicalDevice &device, const char *layer_name, Logger &l)
+NameSet get_device_layer_extensions(
+    const VkPhysicalDevice &device,
+    const char *layer_name,
+    Logger &l,
+    std::pmr::memory_resource *scratch)
 {
     uint32_t nb_extensions = 0;
     VkResult get_nb_status = vkEnumerateDeviceExtensionProperties(
@@ -228,10 +292,10 @@ std::unordered_set<std::string> get_device_layer_extensions(
             "Cannot retreave device layers extension count ({}): Assume no "
             "device layers",
             vk_to_str(get_nb_status));
-        return {};
+        return NameSet(scratch);
     }
 
-    std::vector<VkExtensionProperties> layer_exts(nb_extensions);
+    std::pmr::vector<VkExtensionProperties> layer_exts(nb_extensions, scratch);
     VkResult get_layers_status = vkEnumerateDeviceExtensionProperties(
         device, layer_name, &nb_extensions, layer_exts.data());
 
@@ -240,41 +304,26 @@ std::unordered_set<std::string> get_device_layer_extensions(
             "Cannot retreave device layer extensions ({}): Assume no "
             "device layers",
             vk_to_str(get_layers_status));
-        return {};
+        return NameSet(scratch);
     }
 
-    return collect_extensions(layer_exts, l);
+    return collect_extensions(layer_exts, l, scratch);
 }
 
 LayerExtMap get_device_layers_extensions(
     const VkPhysicalDevice &device,
-    const std::unordered_set<std::string> &layer_names,
-    Logger &l)
+    const NameSet &layer_names,
+    Logger &l,
+    std::pmr::memory_resource *scratch)
 {
-    LayerExtMap output;
-    for (const auto &layer_name : layer_names) {
-        std::unordered_set<std::string> layer_extensions =
-            get_device_layer_extensions(device, layer_name.c_str(), l);
-
-        auto layer_extensions_list = output.find(layer_name);
-
-        if (layer_extensions_list == std::end(output)) {
-            std::unordered_set<std::string> new_extension_list;
-            new_extension_list.reserve(layer_extensions.size());
-            output.emplace(layer_name, std::move(new_extension_list));
-
-            layer_extensions_list = output.find(layer_name);
-            if (layer_extensions_list == std::end(output)) {
-                l.error("No memory for layers extension list");
-                continue;
-            }
-        }
-
-        for (auto &extension : layer_extensions) {
-            layer_extensions_list->second.emplace(std::move(extension));
-        }
-    }
-    return output;
+    return collect_layers_extensions(
+        layer_names,
+        l,
+        scratch,
+        [&device, &l, scratch](const char *layer_name) {
+            return get_device_layer_extensions(
+                device, layer_name, l, scratch);
+        });
 }
 
 } // namespace pvk
@@ -1,5 +1,10 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cstdint>
+#include <cstdlib>
 #include <format>
+#include <iterator>
 #include <iostream>
 #include <ostream>
 #include <string>
@@ -43,6 +48,47 @@ CONSTEXPR_IF_CLANG std::string ansi_reset()
 }
 #endif
 
+namespace {
+
+LogLevel level_from_environment() noexcept
+{
+    constexpr std::array<std::string_view, 7> names{
+        "fatal", "error", "warning", "notice", "info", "debug", "trace"};
+
+    const char *env_level = std::getenv("PVK_LOG_LEVEL");
+    if (env_level == nullptr) {
+        return LogLevel::TRACE;
+    }
+    auto name = std::ranges::find(names, std::string_view(env_level));
+    if (name == std::end(names)) {
+        return LogLevel::TRACE;
+    }
+    return static_cast<LogLevel>(std::distance(std::begin(names), name));
+}
+
+std::atomic<LogLevel> &global_level() noexcept
+{
+    static std::atomic<LogLevel> level{level_from_environment()};
+    return level;
+}
+
+} // namespace
+
+void set_log_level(LogLevel level) noexcept
+{
+    global_level().store(level, std::memory_order_relaxed);
+}
+
+LogLevel get_log_level() noexcept
+{
+    return global_level().load(std::memory_order_relaxed);
+}
+
+bool log_enabled(LogLevel level) noexcept
+{
+    return level <= get_log_level();
+}
+
 void log_lines_to(
     std::ostream &stream,
     const std::string_view prefix,
@@ -58,6 +104,9 @@ void log_lines_to(
 
 void raw_fatal(const std::string_view &message) noexcept
 try {
+    if (!log_enabled(LogLevel::FATAL)) {
+        return;
+    }
     auto lines = split_ln(message);
     std::string prefix = std::format("{}[F]", ansi_color(0xee, 0, 0));
     log_lines_to(std::cout, prefix, ansi_reset(), message, lines);
@@ -66,6 +115,9 @@ try {
 
 void raw_error(const std::string_view &message) noexcept
 try {
+    if (!log_enabled(LogLevel::ERROR)) {
+        return;
+    }
     auto lines = split_ln(message);
     std::string prefix =
         std::format("{}[E]{}", ansi_color(0xff, 0, 0), ansi_reset());
@@ -75,6 +127,9 @@ try {
 
 void raw_warning(const std::string_view &message) noexcept
 try {
+    if (!log_enabled(LogLevel::WARNING)) {
+        return;
+    }
     auto lines = split_ln(message);
 
     std::string prefix =
@@ -85,6 +140,9 @@ try {
 
 void raw_notice(const std::string_view &message) noexcept
 try {
+    if (!log_enabled(LogLevel::NOTICE)) {
+        return;
+    }
     auto lines = split_ln(message);
     std::string prefix =
         std::format("{}[N]{}", ansi_color(0x70, 0xcb, 0xff), ansi_reset());
@@ -94,6 +152,9 @@ try {
 
 void raw_info(const std::string_view &message) noexcept
 try {
+    if (!log_enabled(LogLevel::INFO)) {
+        return;
+    }
     auto lines = split_ln(message);
     log_lines_to(std::cout, "[I]", "", message, lines);
 } catch (...) {
@@ -101,6 +162,9 @@ try {
 
 void raw_debug(const std::string_view &message) noexcept
 try {
+    if (!log_enabled(LogLevel::DEBUG)) {
+        return;
+    }
     std::string prefix = std::format("{}[D]", ansi_color(0x2e, 0x55, 0xff));
     auto lines = split_ln(message);
     log_lines_to(std::cout, prefix, ansi_reset(), message, lines);
@@ -109,6 +173,9 @@ try {
 
 void raw_trace(const std::string_view &message) noexcept
 try {
+    if (!log_enabled(LogLevel::TRACE)) {
+        return;
+    }
     auto lines = split_ln(message);
     std::string prefix_mangled =
         std::format("{}[T]", ansi_color(0x00, 0xff, 0x00));
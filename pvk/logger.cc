@@ -68,6 +68,11 @@ struct Logger::Detail
         Logger::Level level,
         const std::string_view &message) noexcept
     try {
+        const Logger *logger = reinterpret_cast<const Logger *>(user_data);
+        if (!logger->enabled(level)) {
+            return;
+        }
+
         auto lines = split_ln(message);
 
         for (auto line : lines) {
@@ -0,0 +1,86 @@
+#include <format>
+#include <fstream>
+#include <optional>
+#include <string>
+
+#include <cstddef>
+#include <cstdint>
+
+#include <pvk/logger.hh>
+
+#include "pvk/internal/numa.hh"
+#include "pvk/internal/physical_device_info.hh"
+
+namespace pvk::numa {
+
+size_t node_count() noexcept
+try {
+#if defined(__linux__)
+    // "0" or "0-3", the highest online node is the last number
+    std::ifstream online("/sys/devices/system/node/online");
+    std::string nodes;
+    if (!std::getline(online, nodes) || nodes.empty()) {
+        return 1;
+    }
+    size_t last_start = nodes.find_last_of("-,");
+    last_start = last_start == std::string::npos ? 0 : last_start + 1;
+    return std::stoul(nodes.substr(last_start)) + 1;
+#else
+    return 1;
+#endif
+} catch (...) {
+    return 1;
+}
+
+std::optional<int> pci_node(
+    uint32_t domain, uint32_t bus, uint32_t device, uint32_t function) noexcept
+try {
+#if defined(__linux__)
+    std::ifstream numa_node(std::format(
+        "/sys/bus/pci/devices/{:04x}:{:02x}:{:02x}.{:x}/numa_node",
+        domain,
+        bus,
+        device,
+        function));
+    int node = -1;
+    if (!(numa_node >> node) || node < 0) {
+        return std::nullopt;
+    }
+    return node;
+#else
+    (void)domain;
+    (void)bus;
+    (void)device;
+    (void)function;
+    return std::nullopt;
+#endif
+} catch (...) {
+    return std::nullopt;
+}
+
+std::optional<int>
+    device_node(const PhysicalDeviceInfo &info, Logger &l) noexcept
+try {
+    if (!info.pci_address) {
+        l.debug("NUMA: no PCI address, VK_EXT_pci_bus_info is not usable");
+        return std::nullopt;
+    }
+
+    const auto &address = *info.pci_address;
+    std::optional<int> node = pci_node(
+        address.domain, address.bus, address.device, address.function);
+    if (!node) {
+        l.debug(
+            "NUMA: no node for PCI {:04x}:{:02x}:{:02x}.{:x}",
+            address.domain,
+            address.bus,
+            address.device,
+            address.function);
+        return std::nullopt;
+    }
+    return node;
+} catch (...) {
+    return std::nullopt;
+}
+
+} // namespace pvk::numa
@@ -0,0 +1,194 @@
+#include <algorithm>
+#include <cstring>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+#include <pvk/logger.hh>
+
+#include "pvk/internal/capability_cache.hh"
+#include "pvk/internal/layer_utils.hh"
+#include "pvk/internal/physical_device_info.hh"
+#include "pvk/internal/result.hh"
+#include "pvk/internal/vk_api.hh"
+
+namespace {
+
+constexpr size_t core_format_count = VK_FORMAT_ASTC_12x12_SRGB_BLOCK + 1;
+
+constexpr std::string_view pci_bus_info_extension = "VK_EXT_pci_bus_info";
+constexpr auto pci_bus_info_structure_type =
+    static_cast<VkStructureType>(1000212000);
+
+// VkPhysicalDevicePCIBusInfoPropertiesEXT, glad only covers core Vulkan
+struct PciBusInfoPropertiesEXT
+{
+    VkStructureType sType;
+    void *pNext;
+    uint32_t pciDomain;
+    uint32_t pciBus;
+    uint32_t pciDevice;
+    uint32_t pciFunction;
+};
+
+std::string_view extension_name(const VkExtensionProperties &extension)
+{
+    return extension.extensionName;
+}
+
+std::vector<VkExtensionProperties>
+    query_extensions(VkPhysicalDevice device, pvk::Logger &l)
+{
+    uint32_t nb_extensions = 0;
+    VkResult status = vkEnumerateDeviceExtensionProperties(
+        device, nullptr, &nb_extensions, nullptr);
+    if (status != VK_SUCCESS) {
+        l.warning(
+            "Cannot retreave device extension count ({}): Assume none",
+            vk_to_str(status));
+        return {};
+    }
+
+    std::vector<VkExtensionProperties> output(nb_extensions);
+    status = vkEnumerateDeviceExtensionProperties(
+        device, nullptr, &nb_extensions, output.data());
+    if (status != VK_SUCCESS && status != VK_INCOMPLETE) {
+        l.warning(
+            "Cannot retreave device extensions ({}): Assume none",
+            vk_to_str(status));
+        return {};
+    }
+    output.resize(nb_extensions);
+
+    std::ranges::sort(output, {}, extension_name);
+    return output;
+}
+
+} // namespace
+
+namespace pvk {
+
+PhysicalDeviceInfo PhysicalDeviceInfo::query(
+    VkPhysicalDevice device,
+    uint32_t instance_api_version,
+    Logger &l,
+    CapabilityCache *cache)
+{
+    PhysicalDeviceInfo info;
+
+    vkGetPhysicalDeviceProperties(device, &info.properties);
+    vkGetPhysicalDeviceFeatures(device, &info.features);
+    vkGetPhysicalDeviceMemoryProperties(device, &info.memory);
+    info.api_version =
+        std::min(instance_api_version, info.properties.apiVersion);
+
+    uint32_t nb_families = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(device, &nb_families, nullptr);
+    info.queue_families.resize(nb_families);
+    vkGetPhysicalDeviceQueueFamilyProperties(
+        device, &nb_families, info.queue_families.data());
+
+    if (cache != nullptr && cache->restore(info)) {
+        l.debug("Extensions, formats and layers restored from cache");
+    } else {
+        info.extensions = query_extensions(device, l);
+
+        info.formats.resize(core_format_count);
+        for (size_t format_idx = 0; format_idx < core_format_count;
+             format_idx++) {
+            vkGetPhysicalDeviceFormatProperties(
+                device,
+                static_cast<VkFormat>(format_idx),
+                &info.formats[format_idx]);
+        }
+
+        info.layers = to_layer_list(get_device_layers_extensions(
+            device, get_device_layers(device, l), l));
+
+        if (cache != nullptr) {
+            cache->remember(info);
+        }
+    }
+
+    // The per version feature structures are only valid from 1.2 and 1.3
+    if (info.api_version >= VK_API_VERSION_1_2 &&
+        vkGetPhysicalDeviceFeatures2 != nullptr) {
+        VkPhysicalDeviceFeatures2 features{};
+        features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        info.features_11.sType =
+            VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_1_FEATURES;
+        info.features_12.sType =
+            VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+        features.pNext = &info.features_11;
+        info.features_11.pNext = &info.features_12;
+        if (info.api_version >= VK_API_VERSION_1_3) {
+            info.features_13.sType =
+                VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+            info.features_12.pNext = &info.features_13;
+        }
+        vkGetPhysicalDeviceFeatures2(device, &features);
+
+        // The snapshot outlives the chain
+        info.features_11.pNext = nullptr;
+        info.features_12.pNext = nullptr;
+        info.features_13.pNext = nullptr;
+    }
+
+    // vkGetPhysicalDeviceProperties2 is core from 1.1, pvk does not enable
+    // VK_KHR_get_physical_device_properties2 for older instances
+    bool pci_bus_info = info.api_version >= VK_API_VERSION_1_1 &&
+        info.has_extension(pci_bus_info_extension);
+    bool properties_12 = info.api_version >= VK_API_VERSION_1_2;
+    if (vkGetPhysicalDeviceProperties2 == nullptr) {
+        l.debug("vkGetPhysicalDeviceProperties2 is not loaded");
+    } else if (pci_bus_info || properties_12) {
+        PciBusInfoPropertiesEXT bus_info{};
+        bus_info.sType = pci_bus_info_structure_type;
+
+        VkPhysicalDeviceProperties2 props{};
+        props.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+        if (pci_bus_info) {
+            bus_info.pNext = props.pNext;
+            props.pNext = &bus_info;
+        }
+        if (properties_12) {
+            info.properties_12.sType =
+                VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_PROPERTIES;
+            info.properties_12.pNext = props.pNext;
+            props.pNext = &info.properties_12;
+        }
+        vkGetPhysicalDeviceProperties2(device, &props);
+        info.properties_12.pNext = nullptr;
+
+        if (pci_bus_info) {
+            info.pci_address = PciAddress{
+                bus_info.pciDomain,
+                bus_info.pciBus,
+                bus_info.pciDevice,
+                bus_info.pciFunction};
+        }
+    }
+
+    return info;
+}
+
+bool PhysicalDeviceInfo::has_extension(std::string_view name) const
+{
+    return std::ranges::binary_search(extensions, name, {}, extension_name);
+}
+
+const VkFormatProperties &
+    PhysicalDeviceInfo::format_properties(VkFormat format) const
+{
+    static const VkFormatProperties unsupported{};
+    size_t format_idx = static_cast<size_t>(format);
+    if (format_idx >= formats.size()) {
+        return unsupported;
+    }
+    return formats[format_idx];
+}
+
+} // namespace pvk
@@ -1,82 +1,387 @@
+#include <algorithm>
 #include <memory>
 
 #include <cstddef>
+#include <cstdint>
 
 #include <new>
 #include <optional>
 #include <pvk/pipeline.hh>
+#include <span>
+#include <string_view>
 #include <utility>
 #include <vector>
 
 #include <pvk/device.hh>
 #include <pvk/pipeline.hh>
+#include <pvk/pipeline_parameters.hh>
+#include <pvk/specialization.hh>
 
 #include "pvk/log.hh"
 #include "pvk/logger.hh"
 
+#include "pvk/internal/command_pools.hh"
+#include "pvk/internal/descriptor_template.hh"
+#include "pvk/internal/device_impl.hh"
+#include "pvk/internal/pipeline_impl.hh"
+#include "pvk/internal/result.hh"
+#include "pvk/internal/submit_ring.hh"
 #include "pvk/internal/vk_allocator.hh"
 #include "pvk/internal/vk_api.hh"
 
+namespace {
+
+VkDescriptorType descriptor_type(pvk::ParameterKind kind)
+{
+    switch (kind) {
+    case pvk::ParameterKind::STORAGE_BUFFER:
+        return VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    case pvk::ParameterKind::UNIFORM_BUFFER:
+        return VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    case pvk::ParameterKind::STORAGE_IMAGE:
+        return VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    case pvk::ParameterKind::SAMPLED_IMAGE:
+        return VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+    case pvk::ParameterKind::SAMPLER:
+        return VK_DESCRIPTOR_TYPE_SAMPLER;
+    case pvk::ParameterKind::COMBINED_IMAGE_SAMPLER:
+        return VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    case pvk::ParameterKind::STORAGE_TEXEL_BUFFER:
+        return VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER;
+    case pvk::ParameterKind::UNIFORM_TEXEL_BUFFER:
+        return VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
+    }
+    return VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+}
+
+// Size of one entry of the host struct for the kind
+size_t entry_size(pvk::ParameterKind kind)
+{
+    switch (kind) {
+    case pvk::ParameterKind::STORAGE_BUFFER:
+    case pvk::ParameterKind::UNIFORM_BUFFER:
+        return sizeof(VkDescriptorBufferInfo);
+    case pvk::ParameterKind::STORAGE_TEXEL_BUFFER:
+    case pvk::ParameterKind::UNIFORM_TEXEL_BUFFER:
+        return sizeof(VkBufferView);
+    default:
+        return sizeof(VkDescriptorImageInfo);
+    }
+}
+
+constexpr uint32_t spirv_magic = 0x07230203;
+
+} // namespace
+
 namespace pvk {
 
-struct Pipeline::Impl
+Pipeline::Impl::~Impl() noexcept
 {
-    Impl(std::shared_ptr<Device> device_context) noexcept
-        : m_device_context(device_context)
-    {
-        l.set_name("Pipeline");
-        m_allocator = std::make_unique<Allocator>();
+    if (m_device_context == nullptr) {
+        return;
+    }
+    // Recorded work may still use the pipeline and its parameters
+    GpuFuture::wait_all(m_last_dispatches);
+    release_variants(true);
+    VkDevice device =
+        Device::Impl::cast_from(*m_device_context).get_logical_device();
+    if (m_pipeline == VK_NULL_HANDLE) {
+        l.debug("Destroy unconfigured");
     }
+    vkDestroyPipeline(device, m_pipeline, m_allocator->get_callbacks());
+    vkDestroyPipelineLayout(device, m_layout, m_allocator->get_callbacks());
+    destroy_shaders();
+}
 
-    Impl(Impl &&o)
-        : m_shaders(std::move(o.m_shaders)),
-          m_device_context(std::move(o.m_device_context)),
-          m_pipeline(o.m_pipeline), m_allocator(std::move(o.m_allocator)),
-          l(std::move(o.l))
-    {
+void Pipeline::Impl::release_variants(bool wait) noexcept
+{
+    VkDevice device =
+        Device::Impl::cast_from(*m_device_context).get_logical_device();
+    std::erase_if(m_variants, [&](Variant &variant) {
+        if (wait) {
+            GpuFuture::wait_all(variant.dispatches);
+        } else if (!std::ranges::all_of(
+                       variant.dispatches, [](const GpuFuture &dispatch) {
+                           return dispatch.ready() || dispatch.failed();
+                       })) {
+            return false;
+        }
+        vkDestroyPipeline(
+            device, variant.pipeline, m_allocator->get_callbacks());
+        return true;
+    });
+}
+
+void Pipeline::Impl::destroy_shaders() noexcept
+{
+    VkDevice device =
+        Device::Impl::cast_from(*m_device_context).get_logical_device();
+    for (VkShaderModule shader : m_shaders) {
+        vkDestroyShaderModule(device, shader, m_allocator->get_callbacks());
     }
+    m_shaders.clear();
+}
 
-    ~Impl() noexcept
-    {
-        if (m_pipeline == VK_NULL_HANDLE) {
-            l.debug("Destroy unconfigured");
-            return;
+bool Pipeline::Impl::set_compute_shader(
+    std::span<const uint32_t> spirv, std::string_view entry_point) noexcept
+try {
+    if (spirv.empty() || spirv.front() != spirv_magic) {
+        l.warning("Shader module creation failue: Not SPIR-V");
+        return false;
+    }
+
+    VkShaderModuleCreateInfo create_info{};
+    create_info.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+    create_info.codeSize = spirv.size_bytes();
+    create_info.pCode = spirv.data();
+    VkShaderModule shader = VK_NULL_HANDLE;
+    VkResult status = vkCreateShaderModule(
+        Device::Impl::cast_from(*m_device_context).get_logical_device(),
+        &create_info,
+        m_allocator->get_callbacks(),
+        &shader);
+    if (status != VK_SUCCESS) {
+        l.warning("Shader module creation failue: {}", vk_to_str(status));
+        return false;
+    }
+
+    destroy_shaders();
+    m_shaders.emplace_back(shader);
+    m_entry_point = entry_point;
+    return true;
+} catch (...) {
+    l.warning("Shader module creation failue: Out of host memory");
+    return false;
+}
+
+bool Pipeline::Impl::configure(
+    std::span<const SpecializationConstant> constants) noexcept
+try {
+    if (m_shaders.size() == 0) {
+        l.warning("No single shader attached");
+        return false;
+    }
+    // The replaced variant is kept without throwing once built
+    m_variants.reserve(m_variants.size() + 1);
+
+    std::vector<VkSpecializationMapEntry> map_entries;
+    std::vector<std::byte> data;
+    map_entries.reserve(constants.size());
+    for (const SpecializationConstant &constant : constants) {
+        if (constant.size != 4 && constant.size != 8) {
+            l.warning(
+                "Pipeline creation failue: Constant {} is {} bytes",
+                constant.id,
+                constant.size);
+            return false;
+        }
+        bool duplicate = std::ranges::any_of(
+            map_entries, [&](const VkSpecializationMapEntry &entry) {
+                return entry.constantID == constant.id;
+            });
+        if (duplicate) {
+            l.warning(
+                "Pipeline creation failue: Constant {} is set twice",
+                constant.id);
+            return false;
         }
+        map_entries.emplace_back(VkSpecializationMapEntry{
+            constant.id, static_cast<uint32_t>(data.size()), constant.size});
+        data.insert(
+            std::end(data),
+            std::begin(constant.data),
+            std::begin(constant.data) + constant.size);
     }
 
-    bool configure()
-    {
-        if (m_shaders.size() == 0) {
-            l.warning("No single shader attached");
+    VkSpecializationInfo specialization{};
+    specialization.mapEntryCount = static_cast<uint32_t>(map_entries.size());
+    specialization.pMapEntries = map_entries.data();
+    specialization.dataSize = data.size();
+    specialization.pData = data.data();
+
+    VkDevice device =
+        Device::Impl::cast_from(*m_device_context).get_logical_device();
+    if (get_layout() == VK_NULL_HANDLE) {
+        VkPipelineLayoutCreateInfo layout_info{};
+        layout_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        VkResult status = vkCreatePipelineLayout(
+            device, &layout_info, m_allocator->get_callbacks(), &m_layout);
+        if (status != VK_SUCCESS) {
+            l.warning(
+                "Pipeline layout creation failue: {}", vk_to_str(status));
             return false;
         }
+    }
 
-        return true;
+    VkComputePipelineCreateInfo create_info{};
+    create_info.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    create_info.stage.sType =
+        VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    create_info.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    create_info.stage.module = m_shaders.front();
+    create_info.stage.pName = m_entry_point.c_str();
+    create_info.stage.pSpecializationInfo =
+        map_entries.empty() ? nullptr : &specialization;
+    create_info.layout = get_layout();
+    create_info.basePipelineIndex = -1;
+
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    VkResult status = vkCreateComputePipelines(
+        device,
+        VK_NULL_HANDLE,
+        1,
+        &create_info,
+        m_allocator->get_callbacks(),
+        &pipeline);
+    if (status != VK_SUCCESS) {
+        l.warning("Pipeline creation failue: {}", vk_to_str(status));
+        return false;
     }
 
-    static Impl &cast_from(std::byte *data)
     {
-        return *std::launder(reinterpret_cast<Impl *>(data));
+        std::lock_guard lock(m_dispatch_lock);
+        if (m_pipeline != VK_NULL_HANDLE) {
+            m_variants.emplace_back(
+                Variant{m_pipeline, std::move(m_last_dispatches)});
+            m_last_dispatches.clear();
+        }
+        m_pipeline = pipeline;
     }
+    release_variants(false);
+    l.debug("Configured with {} constants", map_entries.size());
+    return true;
+} catch (...) {
+    l.warning("Pipeline creation failue: Out of host memory");
+    return false;
+}
 
-    static Impl const &cast_from(std::byte const *data)
-    {
-        return *std::launder(reinterpret_cast<Impl const *>(data));
+bool Pipeline::Impl::set_parameters(
+    std::span<const PipelineParameter> parameters) noexcept
+try {
+    if (m_pipeline != VK_NULL_HANDLE) {
+        l.warning("Pipeline parameters failue: Pipeline already configured");
+        return false;
+    }
+    Device::Impl &device = Device::Impl::cast_from(*m_device_context);
+    DescriptorCache *cache = device.get_descriptor_cache();
+    if (cache == nullptr) {
+        l.warning("Pipeline parameters failue: Device not connected");
+        return false;
     }
 
-    static bool assert_size()
-    {
-        static_assert(sizeof(Impl) < Pipeline::impl_size);
-        return true;
+    std::vector<DescriptorTemplate::Entry> entries;
+    entries.reserve(parameters.size());
+    for (const PipelineParameter &parameter : parameters) {
+        entries.emplace_back(DescriptorTemplate::Entry{
+            parameter.binding,
+            descriptor_type(parameter.kind),
+            parameter.count,
+            parameter.offset,
+            parameter.stride != 0 ? parameter.stride
+                                  : entry_size(parameter.kind)});
+    }
+
+    auto new_parameters = DescriptorTemplate::create(
+        device.get_logical_device(),
+        device.get_info().api_version,
+        entries,
+        VK_PIPELINE_BIND_POINT_COMPUTE,
+        *cache,
+        device.get_push_descriptor(),
+        device.get_callbacks());
+    if (!new_parameters) {
+        return false;
+    }
+    l.debug(
+        "Parameters {}",
+        new_parameters->pushes() ? "pushed" : "written in sets");
+    m_parameters = std::move(new_parameters);
+    return true;
+} catch (...) {
+    l.warning("Pipeline parameters failue: Out of host memory");
+    return false;
+}
+
+bool Pipeline::Impl::bind_parameters(
+    VkCommandBuffer buffer, const void *parameters) noexcept
+{
+    if (!m_parameters) {
+        l.warning("Parameters binding failue: No parameters set");
+        return false;
     }
+    return m_parameters->bind(buffer, parameters);
+}
 
-  private:
-    std::vector<VkShaderModule> m_shaders;
-    std::shared_ptr<Device> m_device_context;
-    VkPipeline m_pipeline = VK_NULL_HANDLE;
-    std::unique_ptr<Allocator> m_allocator = nullptr;
-    Logger l;
-};
+std::optional<GpuFuture> Pipeline::Impl::dispatch(
+    const void *parameters,
+    uint32_t groups_x,
+    uint32_t groups_y,
+    uint32_t groups_z,
+    size_t nth_queue) noexcept
+{
+    if (m_pipeline == VK_NULL_HANDLE) {
+        l.warning("Dispatch failue: Not configured");
+        return std::nullopt;
+    }
+    if (m_parameters && parameters == nullptr) {
+        l.warning("Dispatch failue: No parameters given");
+        return std::nullopt;
+    }
+
+    Device::Impl &device = Device::Impl::cast_from(*m_device_context);
+    auto queue = device.get_queue(QueueKind::COMPUTE, nth_queue);
+    CommandPools *pools = device.get_command_pools();
+    if (!queue || pools == nullptr) {
+        l.warning("Dispatch failue: No compute queue {}", nth_queue);
+        return std::nullopt;
+    }
+    VkCommandBuffer buffer = pools->primary(queue->family_idx);
+    if (buffer == VK_NULL_HANDLE) {
+        return std::nullopt;
+    }
+
+    // Left in its pool until the frame ends, recorded or not
+    bool recorded = bind(buffer) &&
+        (!m_parameters || bind_parameters(buffer, parameters));
+    if (recorded) {
+        vkCmdDispatch(buffer, groups_x, groups_y, groups_z);
+    }
+    VkResult status = vkEndCommandBuffer(buffer);
+    if (status != VK_SUCCESS) {
+        l.warning("Command buffer end failue: {}", vk_to_str(status));
+        return std::nullopt;
+    }
+    if (!recorded) {
+        return std::nullopt;
+    }
+
+    Submission submission;
+    submission.command_buffer = buffer;
+    GpuFuture future =
+        device.submit(QueueKind::COMPUTE, nth_queue, submission);
+    try {
+        std::lock_guard lock(m_dispatch_lock);
+        if (m_last_dispatches.size() <= nth_queue) {
+            m_last_dispatches.resize(nth_queue + 1);
+        }
+        m_last_dispatches[nth_queue] = future;
+    } catch (...) {
+        // Untracked: waited for right away instead
+        l.warning("Dispatch tracking failue: Out of host memory");
+        future.wait();
+    }
+    return future;
+}
+
+bool Pipeline::Impl::bind(VkCommandBuffer buffer) noexcept
+{
+    if (m_pipeline == VK_NULL_HANDLE) {
+        l.warning("Pipeline binding failue: Not configured");
+        return false;
+    }
+    vkCmdBindPipeline(buffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_pipeline);
+    return true;
+}
 
 Pipeline::Pipeline(Impl &&impl_obj) noexcept
 {
@@ -109,4 +414,48 @@ Pipeline::~Pipeline() noexcept
     Impl::cast_from(impl).~Impl();
 }
 
+HostMemoryStats Pipeline::get_host_memory_stats() const noexcept
+{
+    return Impl::cast_from(impl).get_host_memory_stats();
+}
+
+bool Pipeline::set_parameters(
+    std::span<const PipelineParameter> parameters) noexcept
+{
+    return Impl::cast_from(impl).set_parameters(parameters);
+}
+
+bool Pipeline::pushes_parameters() const noexcept
+{
+    return Impl::cast_from(impl).pushes_parameters();
+}
+
+bool Pipeline::set_compute_shader(
+    std::span<const uint32_t> spirv, std::string_view entry_point) noexcept
+{
+    return Impl::cast_from(impl).set_compute_shader(spirv, entry_point);
+}
+
+bool Pipeline::configure(
+    std::span<const SpecializationConstant> constants) noexcept
+{
+    return Impl::cast_from(impl).configure(constants);
+}
+
+bool Pipeline::configured() const noexcept
+{
+    return Impl::cast_from(impl).configured();
+}
+
+std::optional<GpuFuture> Pipeline::dispatch(
+    const void *parameters,
+    uint32_t groups_x,
+    uint32_t groups_y,
+    uint32_t groups_z,
+    size_t nth_queue) noexcept
+{
+    return Impl::cast_from(impl).dispatch(
+        parameters, groups_x, groups_y, groups_z, nth_queue);
+}
+
 } // namespace pvk
@@ -27,6 +27,9 @@ else()
     target_link_libraries(pvk.shared INTERFACE pvk.symvis.emptymacro)
 endif()
 
+# ========= ARTEFACT DEPENDENCIES ========= #
+target_link_libraries(pvk.shared PRIVATE Threads::Threads)
+
 # ========= ARTEFACT VERSION ========= #
 set_property(TARGET pvk.shared PROPERTY VERSION ${PROJECT_VERSION})
 set_property(TARGET pvk.shared PROPERTY SOVERSION ${PROJECT_VERSION_MAJOR})
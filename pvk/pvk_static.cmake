@@ -23,6 +23,9 @@ endif()
 # ========= ARTEFACT SYMBOL VISIBILITY ========= #
 target_link_libraries(pvk.static INTERFACE pvk.symvis.emptymacro)
 
+# ========= ARTEFACT DEPENDENCIES ========= #
+target_link_libraries(pvk.static INTERFACE Threads::Threads)
+
 
 
 
@@ -0,0 +1,154 @@
+#include <algorithm>
+#include <array>
+#include <optional>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+#include <pvk/logger.hh>
+#include <pvk/queue_plan.hh>
+
+#include "pvk/internal/queue_selection.hh"
+#include "pvk/internal/vk_api.hh"
+
+namespace pvk {
+
+const char *queue_kind_name(QueueKind kind)
+{
+    switch (kind) {
+    case QueueKind::GRAPHICS:
+        return "graphics";
+    case QueueKind::COMPUTE:
+        return "compute";
+    case QueueKind::TRANSFER:
+        return "transfer";
+    }
+    return "unknown";
+}
+
+std::optional<uint32_t> family_rank(QueueKind kind, VkQueueFlags flags)
+{
+    bool graphics = (flags & VK_QUEUE_GRAPHICS_BIT) != 0;
+    bool compute = (flags & VK_QUEUE_COMPUTE_BIT) != 0;
+    // Graphics and compute families support transfers implicitly
+    bool transfer = (flags & VK_QUEUE_TRANSFER_BIT) != 0 || graphics ||
+        compute;
+
+    switch (kind) {
+    case QueueKind::GRAPHICS:
+        return graphics ? std::optional<uint32_t>(0) : std::nullopt;
+    case QueueKind::COMPUTE:
+        if (!compute) {
+            return std::nullopt;
+        }
+        return graphics ? 1 : 0;
+    case QueueKind::TRANSFER:
+        if (!transfer) {
+            return std::nullopt;
+        }
+        if (!graphics && !compute) {
+            return 0;
+        }
+        return graphics ? 2 : 1;
+    }
+    return std::nullopt;
+}
+
+std::optional<QueueSelection> select_queues(
+    const QueuePlan &plan,
+    const std::vector<VkQueueFamilyProperties> &families,
+    Logger &l)
+{
+    QueueSelection output;
+    std::vector<uint32_t> used(families.size(), 0);
+    std::vector<uint32_t> shared_cursor(families.size(), 0);
+    // Slot of queue N of family F is family_slots[F][N]
+    std::vector<std::vector<size_t>> family_slots(families.size());
+
+    // Graphics first, so the general purpose families are not drained
+    // by transfer requests falling back to them
+    constexpr std::array<QueueKind, queue_kind_count> kind_order{
+        QueueKind::GRAPHICS, QueueKind::COMPUTE, QueueKind::TRANSFER};
+
+    for (QueueKind kind : kind_order) {
+        // Candidate families, most specialised first
+        std::vector<uint32_t> candidates;
+        for (uint32_t family_idx = 0; family_idx < families.size();
+             family_idx++) {
+            if (families[family_idx].queueCount != 0 &&
+                family_rank(kind, families[family_idx].queueFlags)) {
+                candidates.emplace_back(family_idx);
+            }
+        }
+        std::ranges::stable_sort(candidates, {}, [&](uint32_t family_idx) {
+            return *family_rank(kind, families[family_idx].queueFlags);
+        });
+
+        for (const QueueRequest &request : plan.requests) {
+            if (request.kind != kind) {
+                continue;
+            }
+            if (candidates.empty()) {
+                l.warning(
+                    "No queue family can serve {} queues",
+                    queue_kind_name(kind));
+                return std::nullopt;
+            }
+
+            auto free_family =
+                std::ranges::find_if(candidates, [&](uint32_t family_idx) {
+                    return used[family_idx] < families[family_idx].queueCount;
+                });
+
+            size_t slot_idx = 0;
+            if (free_family != std::end(candidates)) {
+                uint32_t family_idx = *free_family;
+                slot_idx = output.slots.size();
+                output.slots.emplace_back(QueueSelection::Slot{
+                    family_idx,
+                    used[family_idx]++,
+                    std::clamp(request.priority, 0.0f, 1.0f),
+                    0});
+                family_slots[family_idx].emplace_back(slot_idx);
+            } else {
+                // Every candidate is exhausted: round robin over the
+                // queues of the best family
+                uint32_t family_idx = candidates.front();
+                const auto &slots = family_slots[family_idx];
+                slot_idx = slots[shared_cursor[family_idx]++ % slots.size()];
+                l.notice(
+                    "Out of {} queues: Share queue #{} of family #{}",
+                    queue_kind_name(kind),
+                    output.slots[slot_idx].queue_idx,
+                    family_idx);
+            }
+
+            output.slots[slot_idx].users++;
+            output.by_kind[static_cast<size_t>(kind)].emplace_back(slot_idx);
+        }
+    }
+
+    return output;
+}
+
+QueuePlan default_queue_plan(
+    const std::vector<VkQueueFamilyProperties> &families)
+{
+    QueuePlan output;
+    constexpr std::array<QueueKind, queue_kind_count> kinds{
+        QueueKind::GRAPHICS, QueueKind::COMPUTE, QueueKind::TRANSFER};
+    for (QueueKind kind : kinds) {
+        bool supported =
+            std::ranges::any_of(families, [kind](const auto &family) {
+                return family.queueCount != 0 &&
+                    family_rank(kind, family.queueFlags).has_value();
+            });
+        if (supported) {
+            output.add(kind);
+        }
+    }
+    return output;
+}
+
+} // namespace pvk
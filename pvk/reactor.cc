@@ -0,0 +1,293 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <queue>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+#include <pvk/gpu_future.hh>
+#include <pvk/log.hh>
+#include <pvk/logger.hh>
+#include <pvk/reactor.hh>
+
+#include "pvk/internal/timeline.hh"
+
+namespace {
+
+// Longest block in the driver: watches registered meanwhile wait for it
+constexpr std::chrono::nanoseconds watch_slice = std::chrono::milliseconds(1);
+
+struct Watch
+{
+    std::shared_ptr<pvk::Timeline> timeline;
+    uint64_t value;
+    std::coroutine_handle<> handle;
+};
+
+struct LaterValue
+{
+    bool operator()(const Watch &a, const Watch &b) const
+    {
+        return a.value > b.value;
+    }
+};
+
+// Watches of one timeline, lowest value on top
+struct Watched
+{
+    std::shared_ptr<pvk::Timeline> timeline;
+    std::priority_queue<Watch, std::vector<Watch>, LaterValue> watches;
+    // Failed submissions of the timeline already swept for
+    uint64_t failures = 0;
+};
+
+} // namespace
+
+namespace pvk {
+
+struct Reactor::State
+{
+    Executor executor;
+    std::mutex lock;
+    std::condition_variable wake;
+    std::vector<Watch> incoming;
+    bool stop = false;
+    std::atomic<size_t> pending{0};
+    Logger l;
+    std::thread thread;
+
+    void watch(Watch watch)
+    {
+        pending.fetch_add(1, std::memory_order_relaxed);
+        try {
+            std::lock_guard guard(lock);
+            incoming.emplace_back(std::move(watch));
+        } catch (...) {
+            pending.fetch_sub(1, std::memory_order_relaxed);
+            throw;
+        }
+        wake.notify_one();
+    }
+};
+
+struct Reactor::Impl
+{
+    explicit Impl(std::unique_ptr<State> state) noexcept
+        : m_state(std::move(state))
+    {
+    }
+
+    Impl(Impl &&o) noexcept : m_state(std::move(o.m_state))
+    {
+    }
+
+    ~Impl() noexcept
+    {
+        if (!m_state) {
+            return;
+        }
+        {
+            std::lock_guard lock(m_state->lock);
+            m_state->stop = true;
+        }
+        m_state->wake.notify_one();
+        m_state->thread.join();
+    }
+
+    // nullptr once moved from
+    State *state() const noexcept
+    {
+        return m_state.get();
+    }
+
+    size_t pending() const noexcept
+    {
+        if (!m_state) {
+            return 0;
+        }
+        return m_state->pending.load(std::memory_order_relaxed);
+    }
+
+    static void run(State &state) noexcept;
+
+    static Impl &cast_from(std::byte *data)
+    {
+        return *std::launder(reinterpret_cast<Impl *>(data));
+    }
+
+    static Impl const &cast_from(std::byte const *data)
+    {
+        return *std::launder(reinterpret_cast<Impl const *>(data));
+    }
+
+    static bool assert_size()
+    {
+        static_assert(sizeof(Impl) < Reactor::impl_size);
+        return true;
+    }
+
+  private:
+    std::unique_ptr<State> m_state;
+};
+
+void Reactor::Impl::run(State &state) noexcept
+try {
+    std::vector<Watched> watched;
+    std::vector<Watch> incoming;
+    std::vector<Timeline *> timelines;
+    std::vector<uint64_t> values;
+    std::vector<Watch> swept;
+
+    auto resume = [&state](std::coroutine_handle<> handle) {
+        state.pending.fetch_sub(1, std::memory_order_relaxed);
+        try {
+            if (state.executor) {
+                state.executor(handle);
+            } else {
+                handle.resume();
+            }
+        } catch (...) {
+            state.l.warning("Coroutine resumption failue: Exception escaped");
+        }
+    };
+
+    for (;;) {
+        {
+            std::unique_lock lock(state.lock);
+            if (watched.empty()) {
+                state.wake.wait(lock, [&state]() {
+                    return state.stop || !state.incoming.empty();
+                });
+                if (state.incoming.empty()) {
+                    return;
+                }
+            }
+            std::swap(incoming, state.incoming);
+        }
+
+        for (Watch &watch : incoming) {
+            // Failed before the watch reached the reactor
+            if (watch.timeline->failed(watch.value)) {
+                resume(watch.handle);
+                continue;
+            }
+            auto same_timeline = std::ranges::find_if(
+                watched, [&watch](const Watched &w) {
+                    return w.timeline == watch.timeline;
+                });
+            if (same_timeline == std::end(watched)) {
+                same_timeline = watched.insert(
+                    std::end(watched), Watched{watch.timeline, {}});
+            }
+            same_timeline->watches.emplace(std::move(watch));
+        }
+        incoming.clear();
+
+        // One blocking wait on the lowest pending value of each timeline
+        timelines.clear();
+        values.clear();
+        for (const Watched &w : watched) {
+            timelines.emplace_back(w.timeline.get());
+            values.emplace_back(w.watches.top().value);
+        }
+        Timeline::wait_any(timelines, values, watch_slice);
+
+        for (Watched &w : watched) {
+            uint64_t completed_value = w.timeline->completed();
+            while (!w.watches.empty() &&
+                   w.watches.top().value <= completed_value) {
+                std::coroutine_handle<> handle = w.watches.top().handle;
+                w.watches.pop();
+                resume(handle);
+            }
+
+            // Failed values never complete: swept out of the whole queue
+            // once per new failure
+            uint64_t failures = w.timeline->failures();
+            if (failures == w.failures) {
+                continue;
+            }
+            w.failures = failures;
+            swept.clear();
+            while (!w.watches.empty()) {
+                swept.emplace_back(w.watches.top());
+                w.watches.pop();
+            }
+            for (Watch &watch : swept) {
+                if (w.timeline->failed(watch.value)) {
+                    resume(watch.handle);
+                } else {
+                    w.watches.emplace(std::move(watch));
+                }
+            }
+        }
+        std::erase_if(
+            watched, [](const Watched &w) { return w.watches.empty(); });
+    }
+} catch (...) {
+    state.l.error("Reactor stopped: Out of host memory");
+}
+
+Reactor::Reactor(Impl &&impl_obj) noexcept
+{
+    new (impl) Impl(std::move(impl_obj));
+}
+
+std::optional<Reactor> Reactor::create(Executor executor) noexcept
+try {
+    auto state = std::make_unique<State>();
+    state->executor = std::move(executor);
+    state->l.set_name("Reactor");
+    state->thread = std::thread(&Impl::run, std::ref(*state));
+    return Reactor(Impl(std::move(state)));
+} catch (...) {
+    pvk::error("Reactor::create failue: Cannot start the reactor thread");
+    return std::nullopt;
+}
+
+Reactor::Reactor(Reactor &&o) noexcept
+{
+    new (impl) Impl(std::move(Impl::cast_from(o.impl)));
+}
+
+Reactor::~Reactor() noexcept
+{
+    Impl::cast_from(impl).~Impl();
+}
+
+Reactor::Awaitable Reactor::completion(GpuFuture future) noexcept
+{
+    return Awaitable{Impl::cast_from(impl).state(), std::move(future)};
+}
+
+bool Reactor::watch(
+    State *state, const GpuFuture &future, std::coroutine_handle<> handle)
+{
+    if (!future.m_timeline) {
+        return false;
+    }
+    if (state == nullptr) {
+        pvk::warning("Reactor watch failue: Reactor was moved from");
+        return false;
+    }
+    state->watch(Watch{future.m_timeline, future.m_value, handle});
+    return true;
+}
+
+size_t Reactor::pending() const noexcept
+{
+    return Impl::cast_from(impl).pending();
+}
+
+} // namespace pvk
@@ -0,0 +1,253 @@
+#include <atomic>
+#include <memory>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+#include <pvk/logger.hh>
+
+#include "pvk/internal/result.hh"
+#include "pvk/internal/submit_ring.hh"
+#include "pvk/internal/timeline.hh"
+#include "pvk/internal/vk_api.hh"
+
+namespace {
+
+constexpr uint64_t ring_mask = pvk::SubmitRing::capacity - 1;
+static_assert((pvk::SubmitRing::capacity & ring_mask) == 0);
+
+bool plain(const pvk::Submission &submission)
+{
+    return submission.wait_semaphore == VK_NULL_HANDLE &&
+        submission.signal_semaphore == VK_NULL_HANDLE;
+}
+
+} // namespace
+
+namespace pvk {
+
+SubmitRing::SubmitRing(
+    VkQueue queue,
+    std::shared_ptr<Timeline> timeline,
+    std::string_view name)
+    : m_cells(new Cell[capacity]), m_queue(queue),
+      m_timeline(std::move(timeline)),
+      m_timeline_semaphore(m_timeline->semaphore())
+{
+    // Cell N is free for the ticket N + 1
+    for (size_t cell_idx = 0; cell_idx < capacity; cell_idx++) {
+        m_cells[cell_idx].sequence.store(cell_idx, std::memory_order_relaxed);
+    }
+    // One more for the timeline signal
+    m_infos.reserve(max_batch + 1);
+    m_command_buffers.reserve(max_batch);
+    l.set_name(name);
+    m_thread = std::thread(&SubmitRing::run, this);
+}
+
+SubmitRing::~SubmitRing()
+{
+    m_stop.store(true);
+    m_wake.fetch_add(1);
+    m_wake.notify_one();
+    m_thread.join();
+}
+
+uint64_t SubmitRing::push(const Submission &submission) noexcept
+{
+    uint64_t pos = m_tail.load(std::memory_order_relaxed);
+    Cell *cell = nullptr;
+    for (;;) {
+        cell = &m_cells[pos & ring_mask];
+        uint64_t sequence = cell->sequence.load(std::memory_order_acquire);
+        auto lag = static_cast<int64_t>(sequence - pos);
+        if (lag == 0) {
+            if (m_tail.compare_exchange_weak(
+                    pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (lag < 0) {
+            // Full: the submitter is behind, let it run
+            wake();
+            std::this_thread::yield();
+            pos = m_tail.load(std::memory_order_relaxed);
+        } else {
+            pos = m_tail.load(std::memory_order_relaxed);
+        }
+    }
+
+    cell->submission = submission;
+    cell->sequence.store(pos + 1, std::memory_order_release);
+
+    // Pairs with the fence of the submitter going to sleep
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_sleeping.load(std::memory_order_relaxed)) {
+        wake();
+    }
+    return pos + 1;
+}
+
+void SubmitRing::wait_submitted(uint64_t ticket) const noexcept
+{
+    uint64_t submitted = m_submitted.load(std::memory_order_acquire);
+    while (submitted < ticket) {
+        m_submitted.wait(submitted, std::memory_order_acquire);
+        submitted = m_submitted.load(std::memory_order_acquire);
+    }
+}
+
+void SubmitRing::wake() noexcept
+{
+    m_wake.fetch_add(1, std::memory_order_relaxed);
+    m_wake.notify_one();
+}
+
+bool SubmitRing::ready() const noexcept
+{
+    const Cell &cell = m_cells[m_head & ring_mask];
+    return cell.sequence.load(std::memory_order_acquire) == m_head + 1;
+}
+
+size_t SubmitRing::drain(std::vector<Submission> &batch) noexcept
+{
+    batch.clear();
+    while (batch.size() < max_batch && ready()) {
+        Cell &cell = m_cells[m_head & ring_mask];
+        batch.emplace_back(cell.submission);
+        cell.sequence.store(m_head + capacity, std::memory_order_release);
+        m_head++;
+        if (batch.back().fence != VK_NULL_HANDLE) {
+            break;
+        }
+    }
+    return batch.size();
+}
+
+void SubmitRing::submit(const std::vector<Submission> &batch) noexcept
+{
+    m_infos.clear();
+    m_command_buffers.clear();
+
+    // m_command_buffers never reallocates: both are reserved to max_batch
+    bool extend_plain = false;
+    for (const Submission &submission : batch) {
+        const VkCommandBuffer *command_buffers =
+            m_command_buffers.data() + m_command_buffers.size();
+        uint32_t nb_command_buffers = 0;
+        if (submission.command_buffer != VK_NULL_HANDLE) {
+            m_command_buffers.emplace_back(submission.command_buffer);
+            nb_command_buffers = 1;
+        }
+
+        if (extend_plain && plain(submission)) {
+            m_infos.back().commandBufferCount += nb_command_buffers;
+            continue;
+        }
+
+        VkSubmitInfo &info = m_infos.emplace_back();
+        info = VkSubmitInfo{};
+        info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        info.commandBufferCount = nb_command_buffers;
+        info.pCommandBuffers = command_buffers;
+        if (submission.wait_semaphore != VK_NULL_HANDLE) {
+            info.waitSemaphoreCount = 1;
+            info.pWaitSemaphores = &submission.wait_semaphore;
+            info.pWaitDstStageMask = &submission.wait_stage;
+        }
+        if (submission.signal_semaphore != VK_NULL_HANDLE) {
+            info.signalSemaphoreCount = 1;
+            info.pSignalSemaphores = &submission.signal_semaphore;
+        }
+        extend_plain = plain(submission);
+    }
+
+    // A vkQueueSubmit takes a single fence: the timeline one follows a
+    // batch that brought its own
+    VkFence fence = batch.back().fence;
+    VkFence timeline_fence = signal_timeline();
+    bool follow_up =
+        fence != VK_NULL_HANDLE && timeline_fence != VK_NULL_HANDLE;
+    if (fence == VK_NULL_HANDLE) {
+        fence = timeline_fence;
+    }
+
+    VkResult status = vkQueueSubmit(
+        m_queue,
+        static_cast<uint32_t>(m_infos.size()),
+        m_infos.data(),
+        fence);
+    if (status == VK_SUCCESS && follow_up) {
+        status = vkQueueSubmit(m_queue, 0, nullptr, timeline_fence);
+    }
+
+    if (timeline_fence != VK_NULL_HANDLE) {
+        if (status == VK_SUCCESS) {
+            m_timeline->signals(timeline_fence, m_head);
+        } else {
+            m_timeline->release(timeline_fence);
+        }
+    }
+    if (status != VK_SUCCESS) {
+        l.warning(
+            "Submitting {} submissions failue: {}",
+            batch.size(),
+            vk_to_str(status));
+        m_last_error.store(status, std::memory_order_relaxed);
+        m_timeline->fail(m_head - batch.size() + 1, m_head);
+    }
+}
+
+VkFence SubmitRing::signal_timeline() noexcept
+{
+    if (m_timeline_semaphore == VK_NULL_HANDLE) {
+        return m_timeline->acquire_fence();
+    }
+
+    m_signal_value = m_head;
+    m_timeline_info = VkTimelineSemaphoreSubmitInfo{};
+    m_timeline_info.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+    m_timeline_info.signalSemaphoreValueCount = 1;
+    m_timeline_info.pSignalSemaphoreValues = &m_signal_value;
+
+    VkSubmitInfo &info = m_infos.emplace_back();
+    info = VkSubmitInfo{};
+    info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    info.pNext = &m_timeline_info;
+    info.signalSemaphoreCount = 1;
+    info.pSignalSemaphores = &m_timeline_semaphore;
+    return VK_NULL_HANDLE;
+}
+
+void SubmitRing::run() noexcept
+{
+    std::vector<Submission> batch;
+    batch.reserve(max_batch);
+
+    for (;;) {
+        if (drain(batch) != 0) {
+            submit(batch);
+            m_submitted.store(m_head, std::memory_order_release);
+            m_submitted.notify_all();
+            continue;
+        }
+
+        // Pending work is always submitted before stopping
+        if (m_stop.load()) {
+            return;
+        }
+
+        uint32_t wake_count = m_wake.load();
+        m_sleeping.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!ready() && !m_stop.load()) {
+            m_wake.wait(wake_count);
+        }
+        m_sleeping.store(false, std::memory_order_relaxed);
+    }
+}
+
+} // namespace pvk
@@ -0,0 +1,219 @@
+#include <algorithm>
+#include <iterator>
+#include <mutex>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+#include <pvk/logger.hh>
+#include <pvk/sync_pool_stats.hh>
+
+#include "pvk/internal/result.hh"
+#include "pvk/internal/sync_pools.hh"
+#include "pvk/internal/vk_api.hh"
+
+namespace pvk {
+
+SyncPools::SyncPools(VkDevice device, const VkAllocationCallbacks *callbacks)
+    : m_device(device), m_callbacks(callbacks)
+{
+    l.set_name("SyncPools");
+}
+
+SyncPools::~SyncPools()
+{
+    destroy_all(m_fences, [this](VkFence fence) {
+        vkDestroyFence(m_device, fence, m_callbacks);
+    });
+    destroy_all(m_semaphores, [this](VkSemaphore semaphore) {
+        vkDestroySemaphore(m_device, semaphore, m_callbacks);
+    });
+    destroy_all(m_events, [this](VkEvent event) {
+        vkDestroyEvent(m_device, event, m_callbacks);
+    });
+}
+
+template <typename Handle, typename Create, typename Reset>
+Handle
+    SyncPools::acquire(Pool<Handle> &pool, Create create, Reset reset) noexcept
+{
+    {
+        std::lock_guard lock(pool.lock);
+        if (pool.clean.empty() && !pool.dirty.empty()) {
+            uint64_t nb_dirty = pool.dirty.size();
+            uint64_t calls = reset(pool.dirty);
+            if (calls != 0) {
+                pool.counters.resets += calls;
+                pool.counters.reset_objects += nb_dirty;
+            }
+            std::swap(pool.clean, pool.dirty);
+        }
+        if (!pool.clean.empty()) {
+            Handle handle = pool.clean.back();
+            pool.clean.pop_back();
+            pool.counters.hits++;
+            pool.counters.in_use++;
+            return handle;
+        }
+        pool.counters.misses++;
+    }
+
+    // Nothing to recycle: created outside of the lock
+    Handle handle = VK_NULL_HANDLE;
+    if (!create(handle)) {
+        return VK_NULL_HANDLE;
+    }
+    std::lock_guard lock(pool.lock);
+    pool.counters.in_use++;
+    return handle;
+}
+
+template <typename Handle, typename Destroy>
+void SyncPools::release(
+    Pool<Handle> &pool, Handle handle, Destroy destroy) noexcept
+{
+    if (handle == VK_NULL_HANDLE) {
+        return;
+    }
+    std::lock_guard lock(pool.lock);
+    pool.counters.in_use--;
+    try {
+        pool.dirty.emplace_back(handle);
+    } catch (...) {
+        l.warning("Sync object recycling failue: Out of host memory");
+        destroy(handle);
+    }
+}
+
+template <typename Handle, typename Destroy>
+void SyncPools::destroy_all(Pool<Handle> &pool, Destroy destroy) noexcept
+{
+    std::lock_guard lock(pool.lock);
+    std::ranges::for_each(pool.clean, destroy);
+    std::ranges::for_each(pool.dirty, destroy);
+    pool.clean.clear();
+    pool.dirty.clear();
+    if (pool.counters.in_use != 0) {
+        l.warning(
+            "{} sync objects still in use on pool destruction",
+            pool.counters.in_use);
+    }
+}
+
+VkFence SyncPools::acquire_fence() noexcept
+{
+    auto create = [this](VkFence &fence) {
+        VkFenceCreateInfo create_info{};
+        create_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+        VkResult status =
+            vkCreateFence(m_device, &create_info, m_callbacks, &fence);
+        if (status != VK_SUCCESS) {
+            l.warning("Fence creation failue: {}", vk_to_str(status));
+            return false;
+        }
+        return true;
+    };
+    auto reset = [this](std::vector<VkFence> &fences) -> uint64_t {
+        VkResult status = vkResetFences(
+            m_device, static_cast<uint32_t>(fences.size()), fences.data());
+        if (status != VK_SUCCESS) {
+            // Out of memory only: their state is unknown, drop them all
+            l.warning("Fences reset failue: {}", vk_to_str(status));
+            for (VkFence fence : fences) {
+                vkDestroyFence(m_device, fence, m_callbacks);
+            }
+            fences.clear();
+        }
+        return 1;
+    };
+    return acquire(m_fences, create, reset);
+}
+
+void SyncPools::release_fence(VkFence fence) noexcept
+{
+    release(m_fences, fence, [this](VkFence unpooled) {
+        vkDestroyFence(m_device, unpooled, m_callbacks);
+    });
+}
+
+VkSemaphore SyncPools::acquire_semaphore() noexcept
+{
+    auto create = [this](VkSemaphore &semaphore) {
+        VkSemaphoreCreateInfo create_info{};
+        create_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+        VkResult status = vkCreateSemaphore(
+            m_device, &create_info, m_callbacks, &semaphore);
+        if (status != VK_SUCCESS) {
+            l.warning("Semaphore creation failue: {}", vk_to_str(status));
+            return false;
+        }
+        return true;
+    };
+    // A binary semaphore is unsignaled again once its wait executed
+    auto reset = [](std::vector<VkSemaphore> &) -> uint64_t { return 0; };
+    return acquire(m_semaphores, create, reset);
+}
+
+void SyncPools::release_semaphore(VkSemaphore semaphore) noexcept
+{
+    release(m_semaphores, semaphore, [this](VkSemaphore unpooled) {
+        vkDestroySemaphore(m_device, unpooled, m_callbacks);
+    });
+}
+
+VkEvent SyncPools::acquire_event() noexcept
+{
+    auto create = [this](VkEvent &event) {
+        VkEventCreateInfo create_info{};
+        create_info.sType = VK_STRUCTURE_TYPE_EVENT_CREATE_INFO;
+        VkResult status =
+            vkCreateEvent(m_device, &create_info, m_callbacks, &event);
+        if (status != VK_SUCCESS) {
+            l.warning("Event creation failue: {}", vk_to_str(status));
+            return false;
+        }
+        return true;
+    };
+    // No batched reset for events, one call each
+    auto reset = [this](std::vector<VkEvent> &events) -> uint64_t {
+        uint64_t calls = events.size();
+        auto failed = std::ranges::remove_if(events, [this](VkEvent event) {
+            VkResult status = vkResetEvent(m_device, event);
+            if (status != VK_SUCCESS) {
+                l.warning("Event reset failue: {}", vk_to_str(status));
+                vkDestroyEvent(m_device, event, m_callbacks);
+                return true;
+            }
+            return false;
+        });
+        events.erase(std::begin(failed), std::end(failed));
+        return calls;
+    };
+    return acquire(m_events, create, reset);
+}
+
+void SyncPools::release_event(VkEvent event) noexcept
+{
+    release(m_events, event, [this](VkEvent unpooled) {
+        vkDestroyEvent(m_device, unpooled, m_callbacks);
+    });
+}
+
+SyncPoolStats SyncPools::stats() const noexcept
+{
+    auto snapshot = [](const auto &pool) {
+        std::lock_guard lock(pool.lock);
+        SyncPoolStats::Counters counters = pool.counters;
+        counters.pooled = pool.clean.size() + pool.dirty.size();
+        return counters;
+    };
+
+    SyncPoolStats stats;
+    stats.fences = snapshot(m_fences);
+    stats.semaphores = snapshot(m_semaphores);
+    stats.events = snapshot(m_events);
+    return stats;
+}
+
+} // namespace pvk
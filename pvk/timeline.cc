@@ -0,0 +1,502 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <shared_mutex>
+#include <span>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+#include <pvk/gpu_future.hh>
+#include <pvk/logger.hh>
+
+#include "pvk/internal/result.hh"
+#include "pvk/internal/timeline.hh"
+#include "pvk/internal/vk_api.hh"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Longest driver wait: retire must not be locked out by a waiter whose
+// value only completes at disconnect
+constexpr std::chrono::nanoseconds wait_slice = std::chrono::milliseconds(10);
+constexpr std::chrono::nanoseconds max_backoff = std::chrono::milliseconds(1);
+
+struct Deadline
+{
+    explicit Deadline(std::chrono::nanoseconds timeout)
+        : forever(timeout == pvk::GpuFuture::forever),
+          at(forever ? Clock::time_point::max() : Clock::now() + timeout)
+    {
+    }
+
+    bool expired() const
+    {
+        return !forever && Clock::now() >= at;
+    }
+
+    std::chrono::nanoseconds slice() const
+    {
+        if (forever) {
+            return wait_slice;
+        }
+        auto remaining = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            at - Clock::now());
+        return std::clamp(remaining, std::chrono::nanoseconds(0), wait_slice);
+    }
+
+    bool forever;
+    Clock::time_point at;
+};
+
+uint64_t vk_timeout(std::chrono::nanoseconds timeout)
+{
+    return static_cast<uint64_t>(timeout.count());
+}
+
+} // namespace
+
+namespace pvk {
+
+std::shared_ptr<Timeline> Timeline::create(
+    VkDevice device,
+    bool timeline_semaphores,
+    SyncPools *sync_pools,
+    const VkAllocationCallbacks *callbacks,
+    std::string_view name)
+{
+    std::shared_ptr<Timeline> timeline(new (std::nothrow) Timeline());
+    if (!timeline) {
+        return nullptr;
+    }
+    timeline->l.set_name(name);
+    timeline->m_device = device;
+    timeline->m_callbacks = callbacks;
+    timeline->m_sync_pools = sync_pools;
+    if (!timeline_semaphores) {
+        return timeline;
+    }
+
+    VkSemaphoreTypeCreateInfo type_info{};
+    type_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+    type_info.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+    type_info.initialValue = 0;
+
+    VkSemaphoreCreateInfo create_info{};
+    create_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    create_info.pNext = &type_info;
+
+    VkResult status = vkCreateSemaphore(
+        device, &create_info, callbacks, &timeline->m_semaphore);
+    if (status != VK_SUCCESS) {
+        timeline->l.warning(
+            "Timeline semaphore creation failue: {}", vk_to_str(status));
+        return nullptr;
+    }
+    return timeline;
+}
+
+VkFence Timeline::acquire_fence() noexcept
+{
+    return m_sync_pools->acquire_fence();
+}
+
+void Timeline::signals(VkFence fence, uint64_t value) noexcept
+try {
+    std::lock_guard lock(m_fence_lock);
+    m_pending.emplace_back(PendingFence{value, fence});
+} catch (...) {
+    // Untracked: the value completes with the next batch
+    l.warning("Timeline fence tracking failue: Out of host memory");
+    vkWaitForFences(m_device, 1, &fence, VK_TRUE, UINT64_MAX);
+    m_sync_pools->release_fence(fence);
+}
+
+void Timeline::release(VkFence fence) noexcept
+{
+    m_sync_pools->release_fence(fence);
+}
+
+void Timeline::fail(uint64_t first, uint64_t last) noexcept
+{
+    {
+        std::lock_guard lock(m_failure_lock);
+        if (!m_failed.empty() && m_failed.back().second + 1 >= first) {
+            m_failed.back().second = std::max(m_failed.back().second, last);
+        } else {
+            try {
+                m_failed.emplace_back(first, last);
+            } catch (...) {
+                // Over reported rather than reported as complete
+                l.warning("Timeline failure tracking: Out of host memory");
+                if (m_failed.empty()) {
+                    return;
+                }
+                m_failed.back().second = last;
+            }
+        }
+    }
+    m_failures.fetch_add(1, std::memory_order_release);
+
+    // Continuations of the range run on the next poll
+    std::lock_guard lock(m_continuation_lock);
+    m_next_due.store(0);
+}
+
+bool Timeline::failed(uint64_t value) noexcept
+{
+    if (failures() == 0) {
+        return false;
+    }
+    std::lock_guard lock(m_failure_lock);
+    auto range = std::ranges::lower_bound(
+        m_failed, value, {}, [](const auto &r) { return r.second; });
+    return range != std::end(m_failed) && range->first <= value;
+}
+
+uint64_t Timeline::poll_fences() noexcept
+{
+    // Pending fences are only popped under m_wait_lock, held by the caller
+    uint64_t value = m_completed.load();
+    for (;;) {
+        PendingFence front;
+        {
+            std::lock_guard lock(m_fence_lock);
+            if (m_pending.empty()) {
+                return value;
+            }
+            front = m_pending.front();
+        }
+
+        VkResult status = vkGetFenceStatus(m_device, front.fence);
+        if (status != VK_SUCCESS) {
+            if (status != VK_NOT_READY) {
+                l.warning(
+                    "Timeline fence status failue: {}", vk_to_str(status));
+            }
+            return value;
+        }
+        {
+            std::lock_guard lock(m_fence_lock);
+            m_pending.pop_front();
+        }
+        m_sync_pools->release_fence(front.fence);
+        value = front.value;
+    }
+}
+
+uint64_t Timeline::advance(uint64_t value) noexcept
+{
+    uint64_t completed_value = m_completed.load();
+    while (completed_value < value &&
+           !m_completed.compare_exchange_weak(completed_value, value)) {
+    }
+    completed_value = std::max(completed_value, value);
+    run_due(completed_value);
+    return completed_value;
+}
+
+uint64_t Timeline::completed() noexcept
+{
+    uint64_t value = m_completed.load();
+    {
+        std::shared_lock retire_lock(m_retire_lock);
+        if (m_retired) {
+            return m_completed.load();
+        }
+
+        if (m_semaphore != VK_NULL_HANDLE) {
+            VkResult status =
+                vkGetSemaphoreCounterValue(m_device, m_semaphore, &value);
+            if (status != VK_SUCCESS) {
+                l.warning(
+                    "Timeline counter query failue: {}", vk_to_str(status));
+            }
+        } else {
+            // A waiter is polling already, its progress shows up later
+            std::unique_lock wait_lock(m_wait_lock, std::try_to_lock);
+            if (wait_lock) {
+                value = poll_fences();
+            }
+        }
+    }
+    return advance(value);
+}
+
+bool Timeline::wait(uint64_t value, std::chrono::nanoseconds timeout) noexcept
+{
+    Deadline deadline(timeout);
+    std::chrono::nanoseconds backoff(1000);
+    for (;;) {
+        if (failed(value)) {
+            return false;
+        }
+        uint64_t completed_value = m_completed.load();
+        if (completed_value >= value) {
+            return true;
+        }
+
+        std::shared_lock retire_lock(m_retire_lock);
+        if (m_retired) {
+            return !failed(value);
+        }
+
+        VkResult status = VK_TIMEOUT;
+        if (m_semaphore != VK_NULL_HANDLE) {
+            VkSemaphoreWaitInfo wait_info{};
+            wait_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+            wait_info.semaphoreCount = 1;
+            wait_info.pSemaphores = &m_semaphore;
+            wait_info.pValues = &value;
+            status = vkWaitSemaphores(
+                m_device, &wait_info, vk_timeout(deadline.slice()));
+            if (status == VK_SUCCESS) {
+                completed_value = value;
+            }
+        } else {
+            // Another waiter blocks in the driver for a slice at most
+            std::unique_lock wait_lock(m_wait_lock, std::try_to_lock);
+            if (!wait_lock) {
+                retire_lock.unlock();
+                if (deadline.expired()) {
+                    return false;
+                }
+                std::this_thread::sleep_for(
+                    std::min(backoff, deadline.slice()));
+                backoff = std::min(backoff * 2, max_backoff);
+                continue;
+            }
+
+            completed_value = poll_fences();
+            VkFence fence = VK_NULL_HANDLE;
+            if (completed_value < value) {
+                std::lock_guard lock(m_fence_lock);
+                auto pending = std::ranges::find_if(
+                    m_pending, [value](const PendingFence &p) {
+                        return p.value >= value;
+                    });
+                if (pending != std::end(m_pending)) {
+                    fence = pending->fence;
+                }
+            }
+
+            if (completed_value >= value) {
+                status = VK_SUCCESS;
+            } else if (fence != VK_NULL_HANDLE) {
+                status = vkWaitForFences(
+                    m_device,
+                    1,
+                    &fence,
+                    VK_TRUE,
+                    vk_timeout(deadline.slice()));
+                if (status == VK_SUCCESS) {
+                    completed_value = poll_fences();
+                }
+            } else {
+                // Not handed to the driver yet, nothing to block on
+                wait_lock.unlock();
+                retire_lock.unlock();
+                std::this_thread::sleep_for(
+                    std::min(backoff, deadline.slice()));
+                backoff = std::min(backoff * 2, max_backoff);
+            }
+        }
+
+        if (retire_lock) {
+            retire_lock.unlock();
+        }
+        if (status == VK_SUCCESS) {
+            advance(completed_value);
+            if (completed_value >= value) {
+                return !failed(value);
+            }
+        } else if (status != VK_TIMEOUT) {
+            l.warning("Timeline wait failue: {}", vk_to_str(status));
+            return false;
+        }
+        if (deadline.expired()) {
+            return false;
+        }
+    }
+}
+
+void Timeline::then(uint64_t value, GpuFuture::Continuation continuation)
+{
+    if (failed(value)) {
+        continuation(false);
+        return;
+    }
+    if (completed() >= value) {
+        continuation(!failed(value));
+        return;
+    }
+
+    {
+        std::lock_guard lock(m_continuation_lock);
+        m_continuations.emplace_back(value, std::move(continuation));
+        if (value < m_next_due.load()) {
+            m_next_due.store(value);
+        }
+    }
+    // Completion may have raced the registration
+    run_due(m_completed.load());
+}
+
+void Timeline::run_due(uint64_t completed_value) noexcept
+try {
+    if (completed_value < m_next_due.load()) {
+        return;
+    }
+
+    std::vector<std::pair<bool, GpuFuture::Continuation>> due;
+    {
+        std::lock_guard lock(m_continuation_lock);
+        // Kept queued when this fails, the next poll retries
+        due.reserve(m_continuations.size());
+        uint64_t next_due = UINT64_MAX;
+        auto kept = std::ranges::remove_if(
+            m_continuations,
+            [&](std::pair<uint64_t, GpuFuture::Continuation> &entry) {
+                bool failed_value = failed(entry.first);
+                if (entry.first > completed_value && !failed_value) {
+                    next_due = std::min(next_due, entry.first);
+                    return false;
+                }
+                due.emplace_back(!failed_value, std::move(entry.second));
+                return true;
+            });
+        m_continuations.erase(std::begin(kept), std::end(kept));
+        m_next_due.store(next_due);
+    }
+
+    for (auto &[completed, continuation] : due) {
+        try {
+            continuation(completed);
+        } catch (...) {
+            l.warning("GPU future continuation failue: Exception escaped");
+        }
+    }
+} catch (...) {
+    l.warning("GPU future continuations failue: Out of host memory");
+}
+
+std::optional<size_t> Timeline::wait_any(
+    std::span<Timeline *const> timelines,
+    std::span<const uint64_t> values,
+    std::chrono::nanoseconds timeout) noexcept
+try {
+    auto first_complete = [&]() -> std::optional<size_t> {
+        for (size_t idx = 0; idx < timelines.size(); idx++) {
+            if (timelines[idx]->completed() >= values[idx] ||
+                timelines[idx]->failed(values[idx])) {
+                return idx;
+            }
+        }
+        return std::nullopt;
+    };
+
+    Deadline deadline(timeout);
+    if (auto idx = first_complete(); idx || timelines.empty()) {
+        return idx;
+    }
+
+    VkDevice device = timelines.front()->m_device;
+    bool one_wait = std::ranges::all_of(timelines, [device](Timeline *t) {
+        return t->m_semaphore != VK_NULL_HANDLE && t->m_device == device;
+    });
+
+    // Each timeline locked once, whatever the number of its values
+    std::vector<Timeline *> distinct(
+        std::begin(timelines), std::end(timelines));
+    std::ranges::sort(distinct);
+    distinct.erase(
+        std::begin(std::ranges::unique(distinct)), std::end(distinct));
+
+    std::vector<VkSemaphore> semaphores;
+    if (one_wait) {
+        semaphores.reserve(timelines.size());
+        for (Timeline *timeline : timelines) {
+            semaphores.emplace_back(timeline->m_semaphore);
+        }
+    }
+
+    std::chrono::nanoseconds backoff(1000);
+    for (;;) {
+        if (one_wait) {
+            std::vector<std::shared_lock<std::shared_mutex>> retire_locks;
+            retire_locks.reserve(distinct.size());
+            bool retired = false;
+            for (Timeline *timeline : distinct) {
+                retire_locks.emplace_back(timeline->m_retire_lock);
+                retired = retired || timeline->m_retired;
+            }
+
+            VkResult status = VK_SUCCESS;
+            if (!retired) {
+                VkSemaphoreWaitInfo wait_info{};
+                wait_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+                wait_info.flags = VK_SEMAPHORE_WAIT_ANY_BIT;
+                wait_info.semaphoreCount =
+                    static_cast<uint32_t>(semaphores.size());
+                wait_info.pSemaphores = semaphores.data();
+                wait_info.pValues = values.data();
+                status = vkWaitSemaphores(
+                    device, &wait_info, vk_timeout(deadline.slice()));
+            }
+            retire_locks.clear();
+
+            if (status != VK_SUCCESS && status != VK_TIMEOUT) {
+                timelines.front()->l.warning(
+                    "Timeline wait failue: {}", vk_to_str(status));
+                return std::nullopt;
+            }
+        } else {
+            std::this_thread::sleep_for(std::min(backoff, deadline.slice()));
+            backoff = std::min(backoff * 2, max_backoff);
+        }
+
+        if (auto idx = first_complete()) {
+            return idx;
+        }
+        if (deadline.expired()) {
+            return std::nullopt;
+        }
+    }
+} catch (...) {
+    return std::nullopt;
+}
+
+void Timeline::retire() noexcept
+{
+    {
+        std::unique_lock retire_lock(m_retire_lock);
+        if (m_retired) {
+            return;
+        }
+        m_retired = true;
+
+        if (m_semaphore != VK_NULL_HANDLE) {
+            vkDestroySemaphore(m_device, m_semaphore, m_callbacks);
+            m_semaphore = VK_NULL_HANDLE;
+        }
+
+        // The device is idle, every pending fence signaled
+        std::lock_guard lock(m_fence_lock);
+        for (const PendingFence &pending : m_pending) {
+            m_sync_pools->release_fence(pending.fence);
+        }
+        m_pending.clear();
+    }
+    advance(UINT64_MAX);
+}
+
+} // namespace pvk